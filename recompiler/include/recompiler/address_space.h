@@ -0,0 +1,296 @@
+/**
+ * @file address_space.h
+ * @brief Flat address-indexed tables for control flow analysis
+ *
+ * CHIP-8 code lives in a 4 KB address space, so sets and maps keyed by
+ * address are stored as bitsets and fixed 4096-entry index arrays instead
+ * of node-based trees. Iteration is always in ascending address order, so
+ * these are drop-in replacements for std::set<uint16_t> and
+ * std::map<uint16_t, T> in the analyzer and generator.
+ */
+
+#ifndef RECOMPILER_ADDRESS_SPACE_H
+#define RECOMPILER_ADDRESS_SPACE_H
+
+#include "decoder.h"
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace chip8recomp {
+
+// Number of addressable bytes (the full 12-bit CHIP-8 address space)
+constexpr size_t ADDRESS_SPACE_SIZE = 4096;
+
+/* ============================================================================
+ * Address Set
+ * ========================================================================== */
+
+/**
+ * @brief Set of addresses backed by a 4096-bit bitset
+ *
+ * Addresses outside the address space are never members: inserting one
+ * is a no-op and looking one up returns 0.
+ */
+class AddressSet {
+public:
+    static constexpr size_t WORD_BITS = 64;
+    static constexpr size_t NUM_WORDS = ADDRESS_SPACE_SIZE / WORD_BITS;
+
+    /**
+     * @brief Forward iterator over members in ascending order
+     */
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = uint16_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const uint16_t*;
+        using reference = uint16_t;
+
+        iterator() = default;
+        iterator(const AddressSet* set, size_t addr) : set_(set), addr_(addr) {}
+
+        uint16_t operator*() const { return static_cast<uint16_t>(addr_); }
+        iterator& operator++() { addr_ = set_->next_from(addr_ + 1); return *this; }
+        iterator operator++(int) { iterator tmp = *this; ++*this; return tmp; }
+        bool operator==(const iterator& other) const { return addr_ == other.addr_; }
+        bool operator!=(const iterator& other) const { return addr_ != other.addr_; }
+
+    private:
+        const AddressSet* set_ = nullptr;
+        size_t addr_ = ADDRESS_SPACE_SIZE;
+    };
+
+    AddressSet() = default;
+
+    template<typename It>
+    AddressSet(It first, It last) { insert(first, last); }
+
+    /**
+     * @brief Add an address
+     * @return true if it was not already a member
+     */
+    bool insert(uint16_t addr) {
+        if (addr >= ADDRESS_SPACE_SIZE) return false;
+        uint64_t& word = words_[addr / WORD_BITS];
+        uint64_t bit = uint64_t{1} << (addr % WORD_BITS);
+        if (word & bit) return false;
+        word |= bit;
+        ++size_;
+        return true;
+    }
+
+    template<typename It>
+    void insert(It first, It last) {
+        for (; first != last; ++first) {
+            insert(static_cast<uint16_t>(*first));
+        }
+    }
+
+    void insert(const AddressSet& other) { *this |= other; }
+
+    void erase(uint16_t addr) {
+        if (addr >= ADDRESS_SPACE_SIZE) return;
+        uint64_t& word = words_[addr / WORD_BITS];
+        uint64_t bit = uint64_t{1} << (addr % WORD_BITS);
+        if (word & bit) {
+            word &= ~bit;
+            --size_;
+        }
+    }
+
+    bool contains(uint16_t addr) const {
+        return addr < ADDRESS_SPACE_SIZE &&
+               (words_[addr / WORD_BITS] >> (addr % WORD_BITS)) & 1;
+    }
+
+    size_t count(uint16_t addr) const { return contains(addr) ? 1 : 0; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    void clear() {
+        words_.fill(0);
+        size_ = 0;
+    }
+
+    AddressSet& operator|=(const AddressSet& other) {
+        size_ = 0;
+        for (size_t i = 0; i < NUM_WORDS; ++i) {
+            words_[i] |= other.words_[i];
+            size_ += static_cast<size_t>(std::popcount(words_[i]));
+        }
+        return *this;
+    }
+
+    bool operator==(const AddressSet& other) const { return words_ == other.words_; }
+
+    iterator begin() const { return iterator(this, next_from(0)); }
+    iterator end() const { return iterator(this, ADDRESS_SPACE_SIZE); }
+
+    /**
+     * @brief First member at or after addr (ADDRESS_SPACE_SIZE if none)
+     */
+    size_t next_from(size_t addr) const {
+        size_t w = addr / WORD_BITS;
+        if (w >= NUM_WORDS) return ADDRESS_SPACE_SIZE;
+
+        uint64_t bits = words_[w] & (~uint64_t{0} << (addr % WORD_BITS));
+        while (bits == 0) {
+            if (++w == NUM_WORDS) return ADDRESS_SPACE_SIZE;
+            bits = words_[w];
+        }
+        return w * WORD_BITS + static_cast<size_t>(std::countr_zero(bits));
+    }
+
+private:
+    std::array<uint64_t, NUM_WORDS> words_{};
+    size_t size_ = 0;
+};
+
+/* ============================================================================
+ * Address Map
+ * ========================================================================== */
+
+/**
+ * @brief Map from address to T backed by a 4096-entry slot index
+ *
+ * Values live contiguously in insertion order; a per-address slot array
+ * finds them in O(1) and the key bitset gives address-ordered iteration.
+ * Elements are std::pair<const uint16_t, T>, as in std::map.
+ */
+template<typename T>
+class AddressMap {
+public:
+    using value_type = std::pair<const uint16_t, T>;
+
+    template<bool Const>
+    class basic_iterator {
+    public:
+        using Map = std::conditional_t<Const, const AddressMap, AddressMap>;
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = AddressMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+
+        basic_iterator() = default;
+        basic_iterator(Map* map, AddressSet::iterator it) : map_(map), it_(it) {}
+
+        reference operator*() const { return map_->values_[map_->slot_[*it_]]; }
+        pointer operator->() const { return &**this; }
+        basic_iterator& operator++() { ++it_; return *this; }
+        basic_iterator operator++(int) { basic_iterator tmp = *this; ++*this; return tmp; }
+        bool operator==(const basic_iterator& other) const { return it_ == other.it_; }
+        bool operator!=(const basic_iterator& other) const { return it_ != other.it_; }
+
+    private:
+        Map* map_ = nullptr;
+        AddressSet::iterator it_;
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    size_t count(uint16_t addr) const { return keys_.count(addr); }
+    bool contains(uint16_t addr) const { return keys_.contains(addr); }
+    size_t size() const { return values_.size(); }
+    bool empty() const { return values_.empty(); }
+
+    /**
+     * @brief Access or default-construct the value at addr
+     * @throws std::out_of_range if addr is outside the address space
+     */
+    T& operator[](uint16_t addr) {
+        if (addr >= ADDRESS_SPACE_SIZE) {
+            throw std::out_of_range("AddressMap: address outside address space");
+        }
+        if (keys_.insert(addr)) {
+            slot_[addr] = static_cast<uint16_t>(values_.size());
+            values_.emplace_back(addr, T{});
+        }
+        return values_[slot_[addr]].second;
+    }
+
+    /**
+     * @throws std::out_of_range if addr has no value
+     */
+    T& at(uint16_t addr) {
+        if (!keys_.contains(addr)) throw std::out_of_range("AddressMap::at");
+        return values_[slot_[addr]].second;
+    }
+
+    const T& at(uint16_t addr) const {
+        if (!keys_.contains(addr)) throw std::out_of_range("AddressMap::at");
+        return values_[slot_[addr]].second;
+    }
+
+    /**
+     * @brief Value at addr, or nullptr
+     */
+    T* find(uint16_t addr) {
+        return keys_.contains(addr) ? &values_[slot_[addr]].second : nullptr;
+    }
+
+    const T* find(uint16_t addr) const {
+        return keys_.contains(addr) ? &values_[slot_[addr]].second : nullptr;
+    }
+
+    /** Set of addresses with a value */
+    const AddressSet& keys() const { return keys_; }
+
+    iterator begin() { return iterator(this, keys_.begin()); }
+    iterator end() { return iterator(this, keys_.end()); }
+    const_iterator begin() const { return const_iterator(this, keys_.begin()); }
+    const_iterator end() const { return const_iterator(this, keys_.end()); }
+
+private:
+    std::vector<value_type> values_;
+    std::array<uint16_t, ADDRESS_SPACE_SIZE> slot_{};
+    AddressSet keys_;
+};
+
+/* ============================================================================
+ * Address Space
+ * ========================================================================== */
+
+/**
+ * @brief Per-address view of a decoded instruction list
+ */
+struct AddressSpace {
+    // Marker for addresses without a decoded instruction
+    static constexpr uint32_t NO_INSTRUCTION = UINT32_MAX;
+
+    // Index into the instruction list of the instruction at each address
+    std::array<uint32_t, ADDRESS_SPACE_SIZE> instruction_index;
+
+    // Addresses where a decoded instruction starts
+    AddressSet instruction_starts;
+
+    AddressSpace() { instruction_index.fill(NO_INSTRUCTION); }
+
+    explicit AddressSpace(const std::vector<Instruction>& instructions) : AddressSpace() {
+        for (size_t i = 0; i < instructions.size(); ++i) {
+            uint16_t addr = instructions[i].address;
+            if (addr < ADDRESS_SPACE_SIZE) {
+                instruction_index[addr] = static_cast<uint32_t>(i);
+                instruction_starts.insert(addr);
+            }
+        }
+    }
+
+    bool has_instruction(uint16_t addr) const { return instruction_starts.contains(addr); }
+
+    /** Index of the instruction at addr (only valid if has_instruction(addr)) */
+    size_t index_of(uint16_t addr) const { return instruction_index[addr]; }
+};
+
+} // namespace chip8recomp
+
+#endif // RECOMPILER_ADDRESS_SPACE_H
@@ -10,14 +10,17 @@
 #define RECOMPILER_ANALYZER_H
 
 #include "decoder.h"
+#include "address_space.h"
 #include <cstdint>
-#include <map>
 #include <set>
 #include <vector>
 #include <string>
 
 namespace chip8recomp {
 
+/** JP V0 table entries probed past each base (2-byte entries, V0 = 0, 2, 4, ...) */
+constexpr uint16_t JUMP_TABLE_ENTRIES = 16;
+
 /* ============================================================================
  * Control Flow Structures
  * ========================================================================== */
@@ -70,6 +73,39 @@ struct Function {
     bool is_computed_target = false;
 };
 
+/**
+ * @brief How a data region is used by the program
+ */
+enum class DataKind {
+    SPRITE,         // Read by DRW after LD I, NNN
+    BUFFER,         // Written by FX33 (BCD) or FX55
+    TABLE,          // Read by FX65 or F002, or referenced by LD I with no visible use
+    UNREFERENCED    // Never reached as code and never loaded into I
+};
+
+/**
+ * @brief A run of ROM bytes classified as data
+ */
+struct DataRegion {
+    uint16_t start;     // First byte
+    uint16_t end;       // One past the last byte
+    DataKind kind;
+};
+
+/**
+ * @brief Result of code discovery
+ */
+struct CodeMap {
+    // Discovered instructions in address order
+    std::vector<Instruction> instructions;
+    
+    // Non-code ROM bytes, split into regions of one kind, in address order
+    std::vector<DataRegion> data_regions;
+    
+    // JP V0 table entries rejected as implausible code
+    size_t rejected_jump_targets = 0;
+};
+
 /* ============================================================================
  * Analysis Result
  * ========================================================================== */
@@ -78,23 +114,39 @@ struct Function {
  * @brief Complete control flow analysis result
  */
 struct AnalysisResult {
-    // Original instructions
+    // Instructions found by code discovery, in address order
+    // (may include overlapping instructions at odd addresses)
     std::vector<Instruction> instructions;
     
+    // Address -> instruction index lookup
+    AddressSpace address_space;
+    
+    // ROM bytes covered by discovered instructions
+    AddressSet code_bytes;
+    
+    // ROM bytes never reached as code (sprites, tables, padding)
+    AddressSet data_bytes;
+    
+    // data_bytes split into regions by how the program uses them
+    std::vector<DataRegion> data_regions;
+    
     // Basic blocks indexed by start address
-    std::map<uint16_t, BasicBlock> blocks;
+    AddressMap<BasicBlock> blocks;
     
     // Functions indexed by entry address
-    std::map<uint16_t, Function> functions;
+    AddressMap<Function> functions;
     
     // All addresses that need labels (jump/branch targets)
-    std::set<uint16_t> label_addresses;
+    AddressSet label_addresses;
     
     // All addresses that are CALL targets (function entry points)
-    std::set<uint16_t> call_targets;
+    AddressSet call_targets;
     
     // Addresses that are computed jump (BNNN) targets
-    std::set<uint16_t> computed_jump_bases;
+    AddressSet computed_jump_bases;
+    
+    // Backward JPs closing idle loops (see find_idle_loops)
+    AddressSet idle_loop_jumps;
     
     // Entry point of the program
     uint16_t entry_point = 0x200;
@@ -105,6 +157,9 @@ struct AnalysisResult {
         size_t total_blocks = 0;
         size_t total_functions = 0;
         size_t unreachable_instructions = 0;
+        size_t data_bytes = 0;
+        size_t rejected_jump_targets = 0;
+        size_t idle_loops = 0;
     } stats;
 };
 
@@ -113,21 +168,66 @@ struct AnalysisResult {
  * ========================================================================== */
 
 /**
- * @brief Analyze control flow of a decoded ROM
+ * @brief Find the code in a ROM by recursive descent
+ * 
+ * Follows control flow from the entry point, decoding instructions at
+ * any alignment as they are reached. Jumps, calls and both sides of skips
+ * are followed; paths stop at undecodable opcodes and 0NNN system calls,
+ * which are treated as data.
+ * 
+ * The I-register targets of LD I, NNN in that code are then classified by
+ * the instructions that use them (DRW, FX33, FX55, FX65). JP V0 has no
+ * static target, so a range of table entries is explored last and each
+ * one is kept only if every path from it decodes cleanly and none of it
+ * overlaps a referenced data region. Rejected entries are left to the
+ * interpreter fallback at run time.
+ * 
+ * @param rom_data ROM bytes
+ * @param rom_size Size of ROM in bytes
+ * @param entry_point Entry point address (typically 0x200)
+ * @param base_address Address the ROM is loaded at (typically 0x200)
+ * @return Discovered code and the data region map
+ */
+CodeMap discover_code(const uint8_t* rom_data,
+                      size_t rom_size,
+                      uint16_t entry_point = 0x200,
+                      uint16_t base_address = 0x200);
+
+/**
+ * @brief Analyze control flow of a ROM
  * 
  * Performs the following analysis:
- * 1. Identifies all jump/branch targets (labels)
- * 2. Builds basic blocks
- * 3. Identifies function boundaries (CALL targets)
- * 4. Computes reachability
+ * 1. Discovers code by recursive descent (discover_code)
+ * 2. Identifies all jump/branch targets (labels)
+ * 3. Builds basic blocks
+ * 4. Identifies function boundaries (CALL targets)
+ * 5. Computes reachability and marks the remaining bytes as data
+ * 6. Finds idle loops (find_idle_loops)
  * 
- * @param instructions Decoded instructions from decode_rom()
+ * @param rom_data ROM bytes
+ * @param rom_size Size of ROM in bytes
  * @param entry_point Entry point address (typically 0x200)
  * @return Analysis result with blocks, functions, and labels
  */
-AnalysisResult analyze(const std::vector<Instruction>& instructions,
+AnalysisResult analyze(const uint8_t* rom_data,
+                       size_t rom_size,
                        uint16_t entry_point = 0x200);
 
+/**
+ * @brief Mark loops that can only spin until the next frame
+ * 
+ * An idle loop is a straight run of code closed by a backward JP whose body
+ * only loads registers from the delay timer or constants and skips over
+ * jumps (LD Vx, DT / SE Vx, 0 / JP back, SKP Vx / JP back, JP self). Both
+ * inputs change only between frames, so once control reaches the closing
+ * JP every further iteration repeats the same state: the loop can end the
+ * frame at once. Loops entered from outside anywhere but their head are
+ * left alone. Sets closes_idle_loop on each closing JP.
+ * 
+ * @param result Analysis result (updated in place)
+ */
+void find_idle_loops(AnalysisResult& result);
+
 /**
  * @brief Generate a unique function name for an address
  * 
@@ -158,9 +258,9 @@ void print_analysis_summary(const AnalysisResult& result);
  * ========================================================================== */
 
 /**
- * @brief Check if an instruction at given address might be data (not code)
+ * @brief Check if an address holds data rather than code
  * 
- * Heuristic check for sprite data, etc.
+ * True for addresses code discovery never reached.
  * 
  * @param result Analysis result
  * @param address Address to check
@@ -168,6 +268,20 @@ void print_analysis_summary(const AnalysisResult& result);
  */
 bool is_likely_data(const AnalysisResult& result, uint16_t address);
 
+/**
+ * @brief Find the data region containing an address
+ * 
+ * @param result Analysis result
+ * @param address Address to look up
+ * @return The region, or nullptr if the address is code or outside the ROM
+ */
+const DataRegion* find_data_region(const AnalysisResult& result, uint16_t address);
+
+/**
+ * @brief Get the name of a data region kind (e.g., "sprite")
+ */
+const char* data_kind_name(DataKind kind);
+
 /**
  * @brief Find all possible targets of a computed jump (BNNN)
  * 
@@ -178,8 +292,8 @@ bool is_likely_data(const AnalysisResult& result, uint16_t address);
  * @param base_address Base address from BNNN instruction
  * @return Set of possible target addresses
  */
-std::set<uint16_t> find_computed_jump_targets(const AnalysisResult& result,
-                                               uint16_t base_address);
+AddressSet find_computed_jump_targets(const AnalysisResult& result,
+                                      uint16_t base_address);
 
 } // namespace chip8recomp
 
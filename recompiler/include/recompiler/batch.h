@@ -24,6 +24,7 @@ struct RomMetadata {
     std::string release;           // Optional release date
     int recommended_cpu_freq = 0;  // Recommended CPU frequency (0 = default)
     size_t rom_size = 0;           // Size of ROM data in bytes
+    std::vector<std::string> function_files;  // Split function sources, if any
 };
 
 /**
@@ -71,6 +71,10 @@ enum class InstructionType {
     RND,        // CXNN - Random AND
     DRW,        // DXYN - Draw sprite
     
+    // XO-CHIP audio
+    AUDIO,      // F002 - Load audio pattern from [I]
+    PITCH,      // FX3A - Set audio pitch
+    
     // Invalid/unknown
     UNKNOWN
 };
@@ -96,6 +100,7 @@ struct Instruction {
     bool is_call;               // Subroutine call
     bool is_return;             // Subroutine return
     bool is_terminator;         // Ends a basic block
+    bool closes_idle_loop;      // Backward JP of a loop that only waits on DT/keys (set by analyzer)
 };
 
 /* ============================================================================
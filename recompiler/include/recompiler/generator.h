@@ -34,6 +34,7 @@ struct GeneratorOptions {
     bool emit_address_comments = true;       // Include address comments
     bool emit_timing_calls = false;          // Insert timing checkpoints
     bool use_single_file = true;             // All code in one file vs. per-function
+    size_t functions_per_file = 8;           // Functions per .c file when not use_single_file
     bool single_function_mode = false;       // Put all code in one function (for complex ROMs)
     bool use_prefixed_symbols = false;       // Use prefixed symbols for batch mode
     
@@ -46,14 +47,33 @@ struct GeneratorOptions {
     // ROM embedding
     bool embed_rom_data = true;              // Embed ROM for sprite data
     
+    // Self-modifying code
+    bool smc_detection = true;               // Track writes to code, fall back to interpreter
+    
+    // Idle loops
+    bool idle_loop_detection = true;         // End the frame at once in DT/key wait loops
+    
+    // Key waits
+    bool key_wait_yield = true;              // FX0A ends the frame and resumes after the key
+                                             // (cleared for subroutines, which can't be resumed)
+    
     // Debug settings
     bool debug_mode = false;                 // Extra debug output in generated code
+    bool block_trace = false;                // Record block entries in ctx->PC and the trace ring
 };
 
 /* ============================================================================
  * Generated Output
  * ========================================================================== */
 
+/**
+ * @brief An extra generated source file
+ */
+struct GeneratedSource {
+    std::string file;       // File path (relative to output_dir)
+    std::string content;    // File content
+};
+
 /**
  * @brief Result of code generation
  */
@@ -63,6 +83,11 @@ struct GeneratedOutput {
     std::string rom_data_content;  // rom_data.c content (embedded ROM)
     std::string main_content;      // main.c content
     std::string cmake_content;     // CMakeLists.txt content
+    std::string presets_content;   // CMakePresets.json content
+    
+    // Recompiled functions split out of the main source file
+    // (empty when use_single_file is set)
+    std::vector<GeneratedSource> function_sources;
     
     // File paths (relative to output_dir)
     std::string header_file;
@@ -70,6 +95,7 @@ struct GeneratedOutput {
     std::string rom_data_file;
     std::string main_file;
     std::string cmake_file;
+    std::string presets_file;
 };
 
 /* ============================================================================
@@ -167,9 +193,33 @@ std::string generate_main(const GeneratorOptions& options);
  * @brief Generate CMakeLists.txt content
  * 
  * @param options Generator options
+ * @param function_files Split function source files to build
  * @return CMakeLists.txt content as string
  */
-std::string generate_cmake(const GeneratorOptions& options);
+std::string generate_cmake(const GeneratorOptions& options,
+                           const std::vector<std::string>& function_files = {});
+
+/**
+ * @brief Generate the optimization settings shared by generated CMakeLists
+ * 
+ * Defaults to a Release build, enables IPO/LTO for Release and
+ * RelWithDebInfo when the toolchain supports it (so runtime helpers can
+ * inline into recompiled code), and adds the CHIP8_PGO GENERATE/USE
+ * phases for instrumentation-based profile-guided optimization.
+ * Must be emitted before any target is created.
+ * 
+ * @return CMake snippet as string
+ */
+std::string generate_cmake_build_settings();
+
+/**
+ * @brief Generate CMakePresets.json content for a generated project
+ * 
+ * Presets: release, relwithdebinfo, pgo-generate and pgo-use.
+ * 
+ * @return CMakePresets.json content as string
+ */
+std::string generate_cmake_presets();
 
 /**
  * @brief Generate embedded ROM data file
@@ -9,6 +9,7 @@
 #include <queue>
 #include <sstream>
 #include <iomanip>
+#include <optional>
 
 namespace chip8recomp {
 
@@ -29,22 +30,365 @@ std::string generate_label_name(uint16_t address) {
     return ss.str();
 }
 
-AnalysisResult analyze(const std::vector<Instruction>& instructions,
+namespace {
+
+// Decode the instruction at addr, or nullopt if those bytes cannot be code
+std::optional<Instruction> decode_code_at(const uint8_t* rom_data, size_t rom_size,
+                                          uint16_t base_address, uint16_t addr) {
+    if (addr < base_address || addr + 1u >= ADDRESS_SPACE_SIZE) return std::nullopt;
+    
+    // Both opcode bytes must lie inside the ROM
+    size_t offset = addr - base_address;
+    if (offset + 1 >= rom_size) return std::nullopt;
+    
+    uint16_t opcode = (static_cast<uint16_t>(rom_data[offset]) << 8) | rom_data[offset + 1];
+    Instruction instr = decode_opcode(opcode, addr);
+    
+    // Undecodable opcodes and system calls mark data, not code
+    if (instr.type == InstructionType::UNKNOWN) return std::nullopt;
+    if (instr.type == InstructionType::SYS) return std::nullopt;
+    return instr;
+}
+
+// Queue every static way control can leave an instruction (JP V0 has none)
+void push_successors(const Instruction& instr, std::vector<uint16_t>& worklist) {
+    switch (instr.type) {
+        case InstructionType::JP:
+            worklist.push_back(instr.nnn);
+            break;
+            
+        case InstructionType::CALL:
+            worklist.push_back(instr.nnn);            // Called function
+            worklist.push_back(instr.address + 2);    // Return address
+            break;
+            
+        case InstructionType::RET:
+        case InstructionType::JP_V0:
+            break;
+            
+        case InstructionType::SE_VX_NN:
+        case InstructionType::SNE_VX_NN:
+        case InstructionType::SE_VX_VY:
+        case InstructionType::SNE_VX_VY:
+        case InstructionType::SKP:
+        case InstructionType::SKNP:
+            worklist.push_back(instr.address + 2);    // Not skipped
+            worklist.push_back(instr.address + 4);    // Skipped
+            break;
+            
+        default:
+            worklist.push_back(instr.address + 2);    // Sequential
+            break;
+    }
+}
+
+// Stronger uses win when references overlap
+int data_kind_rank(DataKind kind) {
+    switch (kind) {
+        case DataKind::BUFFER:       return 3;
+        case DataKind::SPRITE:       return 2;
+        case DataKind::TABLE:        return 1;
+        case DataKind::UNREFERENCED: return 0;
+    }
+    return 0;
+}
+
+// Bytes the program points I at, with the strongest use seen for each
+struct DataReferences {
+    AddressSet bytes;
+    std::array<DataKind, ADDRESS_SPACE_SIZE> kind{};
+    
+    void mark(uint16_t start, size_t length, DataKind use) {
+        for (size_t i = 0; i < length; ++i) {
+            uint16_t addr = static_cast<uint16_t>(start + i);
+            if (addr >= ADDRESS_SPACE_SIZE) break;
+            if (bytes.insert(addr) || data_kind_rank(use) > data_kind_rank(kind[addr])) {
+                kind[addr] = use;
+            }
+        }
+    }
+};
+
+// Follow each LD I, NNN forward until I changes or control leaves the
+// straight-line code, recording how the bytes at NNN are used
+void collect_data_references(const AddressMap<Instruction>& code, DataReferences& refs) {
+    for (const auto& [addr, instr] : code) {
+        if (instr.type != InstructionType::LD_I_NNN) continue;
+        
+        bool used = false;
+        for (uint16_t next = addr + 2; const Instruction* use = code.find(next); next += 2) {
+            switch (use->type) {
+                case InstructionType::DRW:
+                    refs.mark(instr.nnn, use->n, DataKind::SPRITE);
+                    used = true;
+                    break;
+                case InstructionType::LD_B_VX:
+                    refs.mark(instr.nnn, 3, DataKind::BUFFER);
+                    used = true;
+                    break;
+                case InstructionType::LD_I_VX:
+                    refs.mark(instr.nnn, use->x + 1u, DataKind::BUFFER);
+                    used = true;
+                    break;
+                case InstructionType::LD_VX_I:
+                    refs.mark(instr.nnn, use->x + 1u, DataKind::TABLE);
+                    used = true;
+                    break;
+                case InstructionType::AUDIO:
+                    refs.mark(instr.nnn, 16, DataKind::TABLE);
+                    used = true;
+                    break;
+                default:
+                    break;
+            }
+            
+            // I changes (FX55/FX65 may advance it, depending on quirks)
+            if (use->type == InstructionType::LD_I_NNN ||
+                use->type == InstructionType::ADD_I_VX ||
+                use->type == InstructionType::LD_F_VX ||
+                use->type == InstructionType::LD_I_VX ||
+                use->type == InstructionType::LD_VX_I) {
+                break;
+            }
+            if (use->is_terminator || use->is_return || use->is_call) break;
+        }
+        
+        // Used somewhere we cannot see (e.g. passed to a subroutine)
+        if (!used) {
+            refs.mark(instr.nnn, 1, DataKind::TABLE);
+        }
+    }
+}
+
+// Longest loop body (in instructions) considered for idle loop detection
+constexpr uint16_t MAX_IDLE_LOOP_LENGTH = 8;
+
+// Can the loop closed by this backward JP only wait on DT and keys?
+bool is_idle_loop(const AnalysisResult& result, const Instruction& jump) {
+    const uint16_t head = jump.nnn;
+    const uint16_t tail = jump.address;
+    if (head > tail || (tail - head) % 2 != 0 || (tail - head) / 2 > MAX_IDLE_LOOP_LENGTH) {
+        return false;
+    }
+    
+    const AddressSpace& space = result.address_space;
+    auto at = [&](uint16_t addr) -> const Instruction* {
+        return space.has_instruction(addr) ? &result.instructions[space.index_of(addr)] : nullptr;
+    };
+    auto inside = [&](uint16_t addr) { return addr >= head && addr <= tail; };
+    
+    // Registers the body loads; a skip may only test one after its load, so
+    // every iteration after the first sees the same values
+    uint16_t loaded_in_body = 0;
+    for (uint16_t addr = head; addr < tail; addr += 2) {
+        const Instruction* instr = at(addr);
+        if (instr && (instr->type == InstructionType::LD_VX_DT ||
+                      instr->type == InstructionType::LD_VX_NN)) {
+            loaded_in_body |= 1u << instr->x;
+        }
+    }
+    
+    uint16_t loaded = 0;
+    auto readable = [&](uint8_t reg) {
+        return !(loaded_in_body & (1u << reg)) || (loaded & (1u << reg));
+    };
+    
+    for (uint16_t addr = head; addr < tail; addr += 2) {
+        const Instruction* instr = at(addr);
+        if (!instr) return false;
+        
+        switch (instr->type) {
+            case InstructionType::LD_VX_DT:
+            case InstructionType::LD_VX_NN:
+                loaded |= 1u << instr->x;
+                break;
+                
+            case InstructionType::SE_VX_VY:
+            case InstructionType::SNE_VX_VY:
+                if (!readable(instr->y)) return false;
+                [[fallthrough]];
+            case InstructionType::SE_VX_NN:
+            case InstructionType::SNE_VX_NN:
+            case InstructionType::SKP:
+            case InstructionType::SKNP: {
+                // Skips may only step over a jump, never over a load
+                const Instruction* skipped = at(addr + 2);
+                if (!readable(instr->x) || !skipped || skipped->type != InstructionType::JP) {
+                    return false;
+                }
+                if (addr + 4 > tail + 2) return false;
+                break;
+            }
+                
+            case InstructionType::JP:
+                // Only exits may leave from inside the body
+                if (inside(instr->nnn)) return false;
+                break;
+                
+            default:
+                return false;
+        }
+    }
+    
+    // Nothing may enter the body except at its head
+    auto enters_body = [&](uint16_t target) {
+        return target > head && target <= tail && (target - head) % 2 == 0;
+    };
+    for (const Instruction& instr : result.instructions) {
+        if (inside(instr.address) && (instr.address - head) % 2 == 0) continue;
+        
+        switch (instr.type) {
+            case InstructionType::JP:
+            case InstructionType::CALL:
+                if (enters_body(instr.nnn)) return false;
+                break;
+            case InstructionType::JP_V0:
+                if (instr.nnn <= tail && instr.nnn + 0xFF >= head) return false;
+                break;
+            default:
+                break;
+        }
+        if (!instr.is_terminator && enters_body(instr.address + 2)) return false;
+        if (instr.is_branch && enters_body(instr.address + 4)) return false;
+    }
+    
+    return true;
+}
+
+} // anonymous namespace
+
+CodeMap discover_code(const uint8_t* rom_data,
+                      size_t rom_size,
+                      uint16_t entry_point,
+                      uint16_t base_address) {
+    AddressMap<Instruction> found;
+    std::vector<uint16_t> table_bases;
+    std::vector<uint16_t> worklist;
+    
+    // Pass 1: code reachable through static control flow
+    worklist.push_back(entry_point);
+    while (!worklist.empty()) {
+        uint16_t addr = worklist.back();
+        worklist.pop_back();
+        
+        if (found.contains(addr)) continue;
+        std::optional<Instruction> instr = decode_code_at(rom_data, rom_size, base_address, addr);
+        if (!instr) continue;
+        
+        found[addr] = *instr;
+        if (instr->type == InstructionType::JP_V0) {
+            table_bases.push_back(instr->nnn);
+        }
+        push_successors(*instr, worklist);
+    }
+    
+    // Pass 2: classify the bytes that code loads into I
+    DataReferences refs;
+    collect_data_references(found, refs);
+    
+    // Pass 3: JP V0 table entries, each explored on its own and kept only
+    // if it is plausible code
+    CodeMap map;
+    for (size_t b = 0; b < table_bases.size(); ++b) {
+        for (uint16_t table_offset = 0; table_offset < JUMP_TABLE_ENTRIES * 2; table_offset += 2) {
+            uint16_t target = table_bases[b] + table_offset;
+            if (target < base_address || found.contains(target)) continue;
+            
+            AddressMap<Instruction> trial;
+            std::vector<uint16_t> trial_bases;
+            bool plausible = true;
+            
+            worklist.assign(1, target);
+            while (plausible && !worklist.empty()) {
+                uint16_t addr = worklist.back();
+                worklist.pop_back();
+                
+                if (found.contains(addr) || trial.contains(addr)) continue;
+                std::optional<Instruction> instr = decode_code_at(rom_data, rom_size, base_address, addr);
+                if (!instr || refs.bytes.contains(addr) || refs.bytes.contains(addr + 1)) {
+                    plausible = false;
+                    break;
+                }
+                
+                trial[addr] = *instr;
+                if (instr->type == InstructionType::JP_V0) {
+                    trial_bases.push_back(instr->nnn);
+                }
+                push_successors(*instr, worklist);
+            }
+            
+            if (!plausible) {
+                ++map.rejected_jump_targets;
+                continue;
+            }
+            for (const auto& [addr, instr] : trial) {
+                found[addr] = instr;
+            }
+            table_bases.insert(table_bases.end(), trial_bases.begin(), trial_bases.end());
+            collect_data_references(trial, refs);
+        }
+    }
+    
+    map.instructions.reserve(found.size());
+    AddressSet code_bytes;
+    for (const auto& [addr, instr] : found) {
+        map.instructions.push_back(instr);
+        code_bytes.insert(addr);
+        code_bytes.insert(addr + 1);
+    }
+    
+    // Split the remaining ROM bytes into runs of one kind
+    for (size_t offset = 0; offset < rom_size; ++offset) {
+        uint16_t addr = static_cast<uint16_t>(base_address + offset);
+        if (addr >= ADDRESS_SPACE_SIZE) break;
+        if (code_bytes.contains(addr)) continue;
+        
+        DataKind kind = refs.bytes.contains(addr) ? refs.kind[addr] : DataKind::UNREFERENCED;
+        if (!map.data_regions.empty() && map.data_regions.back().end == addr &&
+            map.data_regions.back().kind == kind) {
+            map.data_regions.back().end = addr + 1;
+        } else {
+            map.data_regions.push_back({addr, static_cast<uint16_t>(addr + 1), kind});
+        }
+    }
+    
+    return map;
+}
+
+AnalysisResult analyze(const uint8_t* rom_data,
+                       size_t rom_size,
                        uint16_t entry_point) {
+    const uint16_t base_address = 0x200;
+    
     AnalysisResult result;
-    result.instructions = instructions;
+    CodeMap code_map = discover_code(rom_data, rom_size, entry_point, base_address);
+    result.instructions = std::move(code_map.instructions);
+    result.data_regions = std::move(code_map.data_regions);
     result.entry_point = entry_point;
-    result.stats.total_instructions = instructions.size();
+    result.stats.total_instructions = result.instructions.size();
+    result.stats.rejected_jump_targets = code_map.rejected_jump_targets;
+    
+    const std::vector<Instruction>& instructions = result.instructions;
+    
+    // Everything in the ROM that no discovered instruction covers is data
+    for (const auto& instr : instructions) {
+        result.code_bytes.insert(instr.address);
+        result.code_bytes.insert(instr.address + 1);
+    }
+    for (const auto& region : result.data_regions) {
+        for (uint16_t addr = region.start; addr < region.end; ++addr) {
+            result.data_bytes.insert(addr);
+        }
+    }
+    result.stats.data_bytes = result.data_bytes.size();
     
     if (instructions.empty()) {
         return result;
     }
     
-    // Build address-to-index map
-    std::map<uint16_t, size_t> addr_to_idx;
-    for (size_t i = 0; i < instructions.size(); ++i) {
-        addr_to_idx[instructions[i].address] = i;
-    }
+    // Build address-to-index table
+    result.address_space = AddressSpace(instructions);
+    const AddressSpace& space = result.address_space;
     
     // Pass 1: Identify all jump/branch targets and call targets
     result.call_targets.insert(entry_point);  // Entry point is a function
@@ -76,27 +420,32 @@ AnalysisResult analyze(const std::vector<Instruction>& instructions,
                 result.label_addresses.insert(instr.address + 4);  // The skip target
                 break;
                 
+            case InstructionType::LD_VX_K:
+                // Key waits yield and resume at the next instruction
+                result.label_addresses.insert(instr.address + 2);
+                break;
+                
             default:
                 break;
         }
     }
     
     // Pass 2: Build basic blocks
-    std::set<uint16_t> block_starts;
+    AddressSet block_starts;
     block_starts.insert(entry_point);
-    block_starts.insert(result.label_addresses.begin(), result.label_addresses.end());
-    block_starts.insert(result.call_targets.begin(), result.call_targets.end());
+    block_starts.insert(result.label_addresses);
+    block_starts.insert(result.call_targets);
     
     // Also start new blocks after terminators
     for (const auto& instr : instructions) {
-        if (instr.is_terminator && addr_to_idx.count(instr.address + 2)) {
+        if (instr.is_terminator && space.has_instruction(instr.address + 2)) {
             block_starts.insert(instr.address + 2);
         }
     }
     
     // Create blocks
     for (uint16_t start_addr : block_starts) {
-        if (!addr_to_idx.count(start_addr)) {
+        if (!space.has_instruction(start_addr)) {
             continue;  // Address not in ROM
         }
         
@@ -104,8 +453,10 @@ AnalysisResult analyze(const std::vector<Instruction>& instructions,
         block.start_address = start_addr;
         block.is_function_entry = result.call_targets.count(start_addr) > 0;
         
-        size_t idx = addr_to_idx[start_addr];
-        while (idx < instructions.size()) {
+        // Walk forward in two-byte steps; overlapping instructions at the
+        // other alignment belong to their own blocks
+        for (uint16_t addr = start_addr; space.has_instruction(addr); addr += 2) {
+            size_t idx = space.index_of(addr);
             const auto& instr = instructions[idx];
             
             // Check if this instruction belongs to a different block
@@ -134,8 +485,6 @@ AnalysisResult analyze(const std::vector<Instruction>& instructions,
             } else if (instr.is_terminator) {
                 break;
             }
-            
-            ++idx;
         }
         
         // Fall-through successor
@@ -143,12 +492,12 @@ AnalysisResult analyze(const std::vector<Instruction>& instructions,
             size_t last_idx = block.instruction_indices.back();
             const auto& last_instr = instructions[last_idx];
             if (!last_instr.is_terminator && !last_instr.is_return && 
-                addr_to_idx.count(block.end_address)) {
+                space.has_instruction(block.end_address)) {
                 block.successors.push_back(block.end_address);
             }
         }
         
-        result.blocks[start_addr] = block;
+        result.blocks[start_addr] = std::move(block);
     }
     
     result.stats.total_blocks = result.blocks.size();
@@ -156,8 +505,8 @@ AnalysisResult analyze(const std::vector<Instruction>& instructions,
     // Pass 3: Build predecessor lists
     for (auto& [addr, block] : result.blocks) {
         for (uint16_t succ : block.successors) {
-            if (result.blocks.count(succ)) {
-                result.blocks[succ].predecessors.push_back(addr);
+            if (BasicBlock* succ_block = result.blocks.find(succ)) {
+                succ_block->predecessors.push_back(addr);
             }
         }
     }
@@ -175,12 +524,12 @@ AnalysisResult analyze(const std::vector<Instruction>& instructions,
         uint16_t addr = worklist.front();
         worklist.pop();
         
-        if (!result.blocks.count(addr)) continue;
-        if (result.blocks[addr].is_reachable) continue;
+        BasicBlock* block = result.blocks.find(addr);
+        if (!block || block->is_reachable) continue;
         
-        result.blocks[addr].is_reachable = true;
+        block->is_reachable = true;
         
-        for (uint16_t succ : result.blocks[addr].successors) {
+        for (uint16_t succ : block->successors) {
             worklist.push(succ);
         }
     }
@@ -196,7 +545,7 @@ AnalysisResult analyze(const std::vector<Instruction>& instructions,
         // Simple approach: assign blocks starting from entry until we hit
         // another function or return. More sophisticated analysis could
         // use dominance trees.
-        std::set<uint16_t> visited;
+        AddressSet visited;
         std::queue<uint16_t> func_worklist;
         func_worklist.push(target);
         
@@ -205,7 +554,8 @@ AnalysisResult analyze(const std::vector<Instruction>& instructions,
             func_worklist.pop();
             
             if (visited.count(block_addr)) continue;
-            if (!result.blocks.count(block_addr)) continue;
+            const BasicBlock* block = result.blocks.find(block_addr);
+            if (!block) continue;
             
             // Don't cross into other functions (except entry)
             if (block_addr != target && result.call_targets.count(block_addr)) {
@@ -215,13 +565,12 @@ AnalysisResult analyze(const std::vector<Instruction>& instructions,
             visited.insert(block_addr);
             func.block_addresses.push_back(block_addr);
             
-            const auto& block = result.blocks[block_addr];
-            for (uint16_t succ : block.successors) {
+            for (uint16_t succ : block->successors) {
                 func_worklist.push(succ);
             }
         }
         
-        result.functions[target] = func;
+        result.functions[target] = std::move(func);
     }
     
     result.stats.total_functions = result.functions.size();
@@ -233,9 +582,22 @@ AnalysisResult analyze(const std::vector<Instruction>& instructions,
         }
     }
     
+    find_idle_loops(result);
+    
     return result;
 }
 
+void find_idle_loops(AnalysisResult& result) {
+    result.idle_loop_jumps.clear();
+    for (Instruction& instr : result.instructions) {
+        instr.closes_idle_loop = instr.type == InstructionType::JP && is_idle_loop(result, instr);
+        if (instr.closes_idle_loop) {
+            result.idle_loop_jumps.insert(instr.address);
+        }
+    }
+    result.stats.idle_loops = result.idle_loop_jumps.size();
+}
+
 void print_analysis_summary(const AnalysisResult& result) {
     std::cout << "\n=== Analysis Summary ===\n\n";
     
@@ -244,8 +606,21 @@ void print_analysis_summary(const AnalysisResult& result) {
     std::cout << "  Total basic blocks: " << result.stats.total_blocks << "\n";
     std::cout << "  Total functions: " << result.stats.total_functions << "\n";
     std::cout << "  Unreachable instructions: " << result.stats.unreachable_instructions << "\n";
+    std::cout << "  Data bytes: " << result.stats.data_bytes << "\n";
+    std::cout << "  Rejected JP V0 targets: " << result.stats.rejected_jump_targets << "\n";
+    std::cout << "  Idle loops: " << result.stats.idle_loops << "\n";
     std::cout << "\n";
     
+    if (!result.data_regions.empty()) {
+        std::cout << "Data regions:\n";
+        for (const auto& region : result.data_regions) {
+            std::cout << "  0x" << std::hex << region.start << "-0x" << (region.end - 1)
+                      << std::dec << " " << data_kind_name(region.kind)
+                      << " (" << (region.end - region.start) << " bytes)\n";
+        }
+        std::cout << "\n";
+    }
+    
     std::cout << "Functions:\n";
     for (const auto& [addr, func] : result.functions) {
         std::cout << "  " << func.name << " @ 0x" << std::hex << addr << std::dec
@@ -269,24 +644,38 @@ void print_analysis_summary(const AnalysisResult& result) {
 }
 
 bool is_likely_data(const AnalysisResult& result, uint16_t address) {
-    // Check if address is in any reachable block
-    for (const auto& [addr, block] : result.blocks) {
-        if (!block.is_reachable) continue;
-        if (address >= block.start_address && address < block.end_address) {
-            return false;  // It's code
-        }
+    return !result.code_bytes.contains(address);
+}
+
+const DataRegion* find_data_region(const AnalysisResult& result, uint16_t address) {
+    auto it = std::upper_bound(result.data_regions.begin(), result.data_regions.end(), address,
+                               [](uint16_t addr, const DataRegion& region) {
+                                   return addr < region.end;
+                               });
+    if (it == result.data_regions.end() || address < it->start) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+const char* data_kind_name(DataKind kind) {
+    switch (kind) {
+        case DataKind::SPRITE:       return "sprite";
+        case DataKind::BUFFER:       return "buffer";
+        case DataKind::TABLE:        return "table";
+        case DataKind::UNREFERENCED: return "unreferenced";
     }
-    return true;  // Probably data
+    return "unknown";
 }
 
-std::set<uint16_t> find_computed_jump_targets(const AnalysisResult& /*result*/,
-                                               uint16_t base_address) {
+AddressSet find_computed_jump_targets(const AnalysisResult& /*result*/,
+                                      uint16_t base_address) {
     // Simple heuristic: assume V0 can be 0, 2, 4, ... up to some limit
     // A more sophisticated analysis would track V0's value
-    std::set<uint16_t> targets;
+    AddressSet targets;
     
     // Common pattern: jump table with 2-byte entries
-    for (int i = 0; i < 16; ++i) {
+    for (uint16_t i = 0; i < JUMP_TABLE_ENTRIES; ++i) {
         targets.insert(base_address + i * 2);
     }
     
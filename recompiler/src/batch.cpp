@@ -14,6 +14,7 @@
 #include <sstream>
 #include <algorithm>
 #include <map>
+#include <set>
 
 namespace fs = std::filesystem;
 
@@ -140,6 +141,8 @@ static std::string generate_multi_rom_cmake(
     out << "set(CMAKE_C_STANDARD 11)\n";
     out << "set(CMAKE_CXX_STANDARD 17)\n\n";
     
+    out << generate_cmake_build_settings();
+    
     out << "# Find SDL2\n";
     out << "find_package(SDL2 REQUIRED)\n\n";
     
@@ -159,6 +162,9 @@ static std::string generate_multi_rom_cmake(
     out << "set(ROM_SOURCES\n";
     for (const auto& [name, meta] : roms) {
         out << "    " << name << ".c\n";
+        for (const auto& file : meta.function_files) {
+            out << "    " << file << "\n";
+        }
         out << "    " << name << "_rom_data.c\n";
     }
     out << ")\n\n";
@@ -173,6 +179,14 @@ static std::string generate_multi_rom_cmake(
     out << "set(RUNTIME_SOURCES\n";
     out << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/context.c\n";
     out << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/instructions.c\n";
+    out << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/audio.c\n";
+    out << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/idle.c\n";
+    out << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/pacer.c\n";
+    out << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/debugger.c\n";
+    out << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/disasm.c\n";
+    out << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/interpreter.c\n";
+    out << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/lockstep.c\n";
+    out << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/trace.c\n";
     out << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/runtime.c\n";
     out << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/platform_sdl.c\n";
     out << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/platform_headless.c\n";
@@ -194,10 +208,28 @@ static std::string generate_multi_rom_cmake(
     out << "    ${IMGUI_DIR}/backends/imgui_impl_sdlrenderer2.cpp\n";
     out << ")\n\n";
     
+    out << "# Recompiled ROMs, built as one object library so they can be merged\n";
+    out << "# into unity batches and share a precompiled runtime header. Every ROM's\n";
+    out << "# symbols carry its name as a prefix, so batches link without clashes.\n";
+    out << "option(CHIP8_UNITY_BUILD \"Compile ROM sources in unity batches\" ON)\n";
+    out << "set(CHIP8_UNITY_BATCH_SIZE 8 CACHE STRING \"ROM sources per unity batch\")\n";
+    out << "option(CHIP8_PRECOMPILE_HEADERS \"Precompile the runtime headers for ROM sources\" ON)\n\n";
+    
+    out << "add_library(chip8_roms OBJECT ${ROM_SOURCES})\n";
+    out << "if(CHIP8_UNITY_BUILD)\n";
+    out << "    set_target_properties(chip8_roms PROPERTIES\n";
+    out << "        UNITY_BUILD ON\n";
+    out << "        UNITY_BUILD_BATCH_SIZE ${CHIP8_UNITY_BATCH_SIZE}\n";
+    out << "    )\n";
+    out << "endif()\n";
+    out << "if(CHIP8_PRECOMPILE_HEADERS)\n";
+    out << "    target_precompile_headers(chip8_roms PRIVATE <chip8rt/runtime.h>)\n";
+    out << "endif()\n\n";
+    
     out << "# Create executable\n";
     out << "add_executable(chip8_launcher\n";
     out << "    ${MAIN_SOURCES}\n";
-    out << "    ${ROM_SOURCES}\n";
+    out << "    $<TARGET_OBJECTS:chip8_roms>\n";
     out << "    ${RUNTIME_SOURCES}\n";
     out << "    ${IMGUI_SOURCES}\n";
     out << ")\n\n";
@@ -254,8 +286,15 @@ int compile_batch(const BatchOptions& options) {
     // Compile each ROM
     std::vector<std::pair<std::string, RomMetadata>> compiled_roms;
     
+    // ROM names become symbol prefixes, so they must be unique
+    std::set<std::string> used_names;
+    
     for (const auto& rom_path : rom_files) {
         std::string rom_name = extract_rom_name(rom_path.string());
+        for (int suffix = 2; used_names.count(rom_name); ++suffix) {
+            rom_name = extract_rom_name(rom_path.string()) + "_" + std::to_string(suffix);
+        }
+        used_names.insert(rom_name);
         std::cout << "Compiling: " << rom_name << " (" << rom_path.filename() << ")\n";
         
         // Load ROM
@@ -271,11 +310,8 @@ int compile_batch(const BatchOptions& options) {
             continue;
         }
         
-        // Decode
-        auto instructions = decode_rom(rom->bytes(), rom->size());
-        
-        // Analyze
-        auto analysis = analyze(instructions);
+        // Discover code and analyze
+        auto analysis = analyze(rom->bytes(), rom->size());
         
         // Get metadata or create default
         RomMetadata meta;
@@ -329,6 +365,13 @@ int compile_batch(const BatchOptions& options) {
         if (!write_file(output.source_file, output.source_content)) continue;
         if (!write_file(output.rom_data_file, output.rom_data_content)) continue;
         
+        bool parts_written = true;
+        for (const auto& source : output.function_sources) {
+            parts_written = parts_written && write_file(source.file, source.content);
+            meta.function_files.push_back(source.file);
+        }
+        if (!parts_written) continue;
+        
         compiled_roms.push_back({rom_name, meta});
         std::cout << "  Success\n";
     }
@@ -358,15 +401,18 @@ int compile_batch(const BatchOptions& options) {
         std::ofstream file(options.output_dir / "CMakeLists.txt");
         file << cmake_content;
     }
+    {
+        std::ofstream file(options.output_dir / "CMakePresets.json");
+        file << generate_cmake_presets();
+    }
     
     std::cout << "\nMulti-ROM compilation complete!\n";
     std::cout << "Generated files in: " << options.output_dir << "\n\n";
     std::cout << "Build instructions:\n";
     std::cout << "  cd " << options.output_dir << "\n";
-    std::cout << "  mkdir build && cd build\n";
-    std::cout << "  cmake -G Ninja ..\n";
-    std::cout << "  cmake --build .\n";
-    std::cout << "  ./chip8_launcher\n";
+    std::cout << "  cmake --preset release\n";
+    std::cout << "  cmake --build --preset release\n";
+    std::cout << "  ./build/release/chip8_launcher\n";
     
     return 0;
 }
@@ -131,6 +131,10 @@ Instruction decode_opcode(uint16_t opcode, uint16_t address) {
             
         case 0xF:  // Misc
             switch (instr.nn) {
+                case 0x02:
+                    instr.type = instr.x == 0 ? InstructionType::AUDIO
+                                              : InstructionType::UNKNOWN;
+                    break;
                 case 0x07: instr.type = InstructionType::LD_VX_DT; break;
                 case 0x0A: instr.type = InstructionType::LD_VX_K; break;
                 case 0x15: instr.type = InstructionType::LD_DT_VX; break;
@@ -138,6 +142,7 @@ Instruction decode_opcode(uint16_t opcode, uint16_t address) {
                 case 0x1E: instr.type = InstructionType::ADD_I_VX; break;
                 case 0x29: instr.type = InstructionType::LD_F_VX; break;
                 case 0x33: instr.type = InstructionType::LD_B_VX; break;
+                case 0x3A: instr.type = InstructionType::PITCH; break;
                 case 0x55: instr.type = InstructionType::LD_I_VX; break;
                 case 0x65: instr.type = InstructionType::LD_VX_I; break;
                 default:   instr.type = InstructionType::UNKNOWN; break;
@@ -204,6 +209,8 @@ const char* instruction_mnemonic(InstructionType type) {
         case InstructionType::SHL_VX:     return "SHL";
         case InstructionType::RND:        return "RND";
         case InstructionType::DRW:        return "DRW";
+        case InstructionType::AUDIO:      return "LD";
+        case InstructionType::PITCH:      return "LD";
         case InstructionType::UNKNOWN:    return "???";
     }
     return "???";
@@ -297,6 +304,14 @@ std::string disassemble(const Instruction& instr) {
             ss << "B, V" << std::hex << (int)instr.x;
             break;
             
+        case InstructionType::AUDIO:
+            ss << "AUDIO, [I]";
+            break;
+            
+        case InstructionType::PITCH:
+            ss << "PITCH, V" << std::hex << (int)instr.x;
+            break;
+            
         case InstructionType::LD_I_VX:
             ss << "[I], V" << std::hex << (int)instr.x;
             break;
@@ -10,8 +10,7 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
-#include <queue>
-#include <map>
+#include <optional>
 
 namespace chip8recomp {
 
@@ -42,10 +41,66 @@ static std::string generate_prefixed_func(uint16_t address, const std::string& p
 }
 
 static void generate_single_function(const AnalysisResult& analysis,
-                                      const uint8_t* rom_data,
-                                      size_t rom_size,
                                       const GeneratorOptions& options,
-                                      std::ostream& out);
+                                      std::ostream& out,
+                                      AddressSet& code_addrs,
+                                      AddressSet& resume_addrs);
+
+// Helper to emit a per-address bitmap as a C array (trailing zeros omitted)
+static void emit_address_bitmap(std::ostream& out, const std::string& name,
+                                const AddressSet& addrs) {
+    std::vector<uint8_t> bits(4096 / 8, 0);
+    for (uint16_t addr : addrs) {
+        if (addr < 4096) {
+            bits[addr >> 3] |= static_cast<uint8_t>(1u << (addr & 7));
+        }
+    }
+    while (!bits.empty() && bits.back() == 0) {
+        bits.pop_back();
+    }
+    
+    out << "static const uint8_t " << name << "[CHIP8_CODE_MAP_SIZE] = {";
+    for (size_t i = 0; i < bits.size(); ++i) {
+        out << (i % 16 == 0 ? "\n    " : " ");
+        out << "0x" << std::hex << std::setfill('0') << std::setw(2) << (int)bits[i] << ",";
+    }
+    out << std::dec << "\n};\n\n";
+}
+
+// Emit the code description the runtime uses for self-modifying code detection
+static void emit_code_info(std::ostream& out,
+                           const GeneratorOptions& options,
+                           const AddressSet& code_addrs,
+                           const AddressSet& resume_addrs) {
+    const std::string& prefix = options.output_prefix;
+    
+    out << "/* Recompiled code layout (for self-modifying code detection) */\n";
+    if (options.smc_detection) {
+        emit_address_bitmap(out, prefix + "_code_map", code_addrs);
+    }
+    if (options.single_function_mode) {
+        emit_address_bitmap(out, prefix + "_resume_map", resume_addrs);
+    }
+    
+    std::vector<std::string> quirks;
+    if (options.quirk_vf_reset) quirks.push_back("CHIP8_QUIRK_VF_RESET");
+    if (options.quirk_shift_uses_vy) quirks.push_back("CHIP8_QUIRK_SHIFT_VY");
+    if (options.quirk_load_store_inc_i) quirks.push_back("CHIP8_QUIRK_LOAD_STORE_INC_I");
+    
+    out << "static const Chip8CodeInfo " << prefix << "_code_info = {\n";
+    out << "    " << (options.smc_detection ? prefix + "_code_map" : "NULL") << ",\n";
+    out << "    " << (options.single_function_mode ? prefix + "_resume_map" : "NULL") << ",\n";
+    out << "    ";
+    if (quirks.empty()) {
+        out << "0";
+    }
+    for (size_t i = 0; i < quirks.size(); ++i) {
+        out << (i ? " | " : "") << quirks[i];
+    }
+    out << ",\n";
+    out << "    " << (options.block_trace ? "true" : "false") << "\n";
+    out << "};\n\n";
+}
 
 GeneratedOutput generate(const AnalysisResult& analysis,
                          const uint8_t* rom_data,
@@ -58,9 +113,9 @@ GeneratedOutput generate(const AnalysisResult& analysis,
     output.rom_data_file = "rom_data.c";
     output.main_file = "main.c";
     output.cmake_file = "CMakeLists.txt";
+    output.presets_file = "CMakePresets.json";
     
     output.main_content = generate_main(options);
-    output.cmake_content = generate_cmake(options);
     
     if (options.embed_rom_data) {
         output.rom_data_content = generate_rom_data(rom_data, rom_size, options);
@@ -78,17 +133,80 @@ GeneratedOutput generate(const AnalysisResult& analysis,
     
     src << "#include \"" << options.output_prefix << ".h\"\n\n";
     
+    // Split output: functions go to <prefix>_funcs_<n>.c, each including the
+    // shared header, so the host compiler can build them in parallel
+    std::ostringstream part;
+    size_t part_functions = 0;
+    auto function_out = [&]() -> std::ostream& {
+        return options.use_single_file ? static_cast<std::ostream&>(src) : part;
+    };
+    auto flush_part = [&]() {
+        if (options.use_single_file || part_functions == 0) return;
+        
+        std::string file = options.output_prefix + "_funcs_" +
+                           std::to_string(output.function_sources.size()) + ".c";
+        std::ostringstream content;
+        content << "/**\n";
+        content << " * @file " << file << "\n";
+        content << " * @brief Recompiled CHIP-8 functions (part " 
+                << output.function_sources.size() << ")\n";
+        content << " * \n";
+        content << " * Auto-generated by chip8recomp - DO NOT EDIT\n";
+        content << " */\n\n";
+        content << "#include \"" << options.output_prefix << ".h\"\n\n";
+        content << part.str();
+        
+        output.function_sources.push_back({file, content.str()});
+        part.str("");
+        part_functions = 0;
+    };
+    
+    AddressSet code_addrs;
+    AddressSet resume_addrs;
+    
     if (options.single_function_mode) {
         // Single function mode - all code in one function
-        generate_single_function(analysis, rom_data, rom_size, options, src);
+        generate_single_function(analysis, options, function_out(),
+                                 code_addrs, resume_addrs);
+        function_out() << "\n";
+        ++part_functions;
+        flush_part();
     } else {
         // Normal mode - separate functions
         for (const auto& [addr, func] : analysis.functions) {
-            generate_function(func, analysis, options, src);
-            src << "\n";
+            generate_function(func, analysis, options, function_out());
+            function_out() << "\n";
+            
+            if (++part_functions >= std::max<size_t>(options.functions_per_file, 1)) {
+                flush_part();
+            }
+            
+            for (uint16_t block_addr : func.block_addresses) {
+                const BasicBlock* block = analysis.blocks.find(block_addr);
+                if (!block) continue;
+                for (size_t idx : block->instruction_indices) {
+                    code_addrs.insert(analysis.instructions[idx].address);
+                }
+            }
         }
+        flush_part();
     }
     
+    std::vector<std::string> function_files;
+    for (const auto& source : output.function_sources) {
+        function_files.push_back(source.file);
+    }
+    output.cmake_content = generate_cmake(options, function_files);
+    output.presets_content = generate_cmake_presets();
+    
+    // Each instruction occupies two bytes
+    AddressSet code_bytes;
+    for (uint16_t addr : code_addrs) {
+        code_bytes.insert(addr);
+        code_bytes.insert(addr + 1);
+    }
+    emit_code_info(src, options, code_bytes, resume_addrs);
+    
     // Helper to get prefixed function name
     auto get_func_name = [&](const std::string& name) {
         if (options.use_prefixed_symbols) {
@@ -100,9 +218,8 @@ GeneratedOutput generate(const AnalysisResult& analysis,
     // Generate function registration (for computed jumps)
     src << "/* Register all functions for computed jump lookup */\n";
     src << "void " << options.output_prefix << "_register_functions(void) {\n";
-    if (options.single_function_mode) {
-        src << "    chip8_register_function(0x200, " << options.output_prefix << "_main);\n";
-    } else {
+    src << "    chip8_register_code_info(&" << options.output_prefix << "_code_info);\n";
+    if (!options.single_function_mode) {
         for (const auto& [addr, func] : analysis.functions) {
             src << "    chip8_register_function(0x" << std::hex << addr << ", " 
                 << get_func_name(func.name) << ");\n";
@@ -134,11 +251,16 @@ bool write_output(const GeneratedOutput& output,
     if (!write_file(output.source_file, output.source_content)) return false;
     if (!write_file(output.main_file, output.main_content)) return false;
     if (!write_file(output.cmake_file, output.cmake_content)) return false;
+    if (!write_file(output.presets_file, output.presets_content)) return false;
     
     if (!output.rom_data_content.empty()) {
         if (!write_file(output.rom_data_file, output.rom_data_content)) return false;
     }
     
+    for (const auto& source : output.function_sources) {
+        if (!write_file(source.file, source.content)) return false;
+    }
+    
     return true;
 }
 
@@ -176,6 +298,17 @@ static std::string generate_instruction_code(const Instruction& instr,
     auto label = [&prefix](uint16_t addr) { return generate_prefixed_label(addr, prefix); };
     auto func = [&prefix](uint16_t addr) { return generate_prefixed_func(addr, prefix); };
     
+    // Stores that may overwrite recompiled code hand off to the interpreter
+    auto smc_guard = [&options](uint16_t next_pc) {
+        std::ostringstream guard;
+        if (options.smc_detection) {
+            guard << " " << (options.single_function_mode ? "CHIP8_SMC_GUARD(ctx, 0x"
+                                                          : "CHIP8_SMC_GUARD_FUNC(ctx, 0x")
+                  << std::hex << next_pc << (options.single_function_mode ? ", dispatch);" : ");");
+        }
+        return guard.str();
+    };
+    
     switch (instr.type) {
         case InstructionType::CLS:
             code << "chip8_clear_screen(ctx);";
@@ -187,7 +320,9 @@ static std::string generate_instruction_code(const Instruction& instr,
             
         case InstructionType::JP:
             // For backward jumps, yield to allow frame processing
-            if (instr.nnn <= instr.address) {
+            if (instr.nnn <= instr.address && instr.closes_idle_loop && options.idle_loop_detection) {
+                code << "CHIP8_IDLE_YIELD(ctx, 0x" << std::hex << instr.nnn << ");";
+            } else if (instr.nnn <= instr.address) {
                 code << "if (--ctx->cycles_remaining <= 0) { ctx->resume_pc = 0x" 
                      << std::hex << instr.nnn << "; ctx->should_yield = true; return; } "
                      << "goto " << label(instr.nnn) << ";";
@@ -306,7 +441,7 @@ static std::string generate_instruction_code(const Instruction& instr,
             
         case InstructionType::RND:
             code << "ctx->V[0x" << std::hex << (int)instr.x 
-                 << "] = chip8_random_byte() & 0x" << (int)instr.nn << ";";
+                 << "] = chip8_random_next(ctx) & 0x" << (int)instr.nn << ";";
             break;
             
         case InstructionType::DRW:
@@ -332,7 +467,12 @@ static std::string generate_instruction_code(const Instruction& instr,
             break;
             
         case InstructionType::LD_VX_K:
-            code << "chip8_wait_key(ctx, 0x" << std::hex << (int)instr.x << ");";
+            if (options.key_wait_yield) {
+                code << "CHIP8_WAIT_KEY(ctx, 0x" << std::hex << (int)instr.x
+                     << ", 0x" << (instr.address + 2) << ");";
+            } else {
+                code << "chip8_wait_key(ctx, 0x" << std::hex << (int)instr.x << ");";
+            }
             break;
             
         case InstructionType::LD_DT_VX:
@@ -340,7 +480,7 @@ static std::string generate_instruction_code(const Instruction& instr,
             break;
             
         case InstructionType::LD_ST_VX:
-            code << "ctx->sound_timer = ctx->V[0x" << std::hex << (int)instr.x << "];";
+            code << "chip8_set_sound_timer(ctx, ctx->V[0x" << std::hex << (int)instr.x << "]);";
             break;
             
         case InstructionType::ADD_I_VX:
@@ -355,11 +495,13 @@ static std::string generate_instruction_code(const Instruction& instr,
             
         case InstructionType::LD_B_VX:
             code << "chip8_store_bcd(ctx, 0x" << std::hex << (int)instr.x << ");";
+            code << smc_guard(instr.address + 2);
             break;
             
         case InstructionType::LD_I_VX:
             code << "chip8_store_registers(ctx, 0x" << std::hex << (int)instr.x 
                  << ", " << (options.quirk_load_store_inc_i ? "true" : "false") << ");";
+            code << smc_guard(instr.address + 2);
             break;
             
         case InstructionType::LD_VX_I:
@@ -367,6 +509,14 @@ static std::string generate_instruction_code(const Instruction& instr,
                  << ", " << (options.quirk_load_store_inc_i ? "true" : "false") << ");";
             break;
             
+        case InstructionType::AUDIO:
+            code << "chip8_load_audio_pattern(ctx);";
+            break;
+            
+        case InstructionType::PITCH:
+            code << "chip8_set_audio_pitch(ctx, 0x" << std::hex << (int)instr.x << ");";
+            break;
+            
         case InstructionType::SYS:
             code << "/* SYS 0x" << std::hex << instr.nnn << " - ignored */";
             break;
@@ -392,6 +542,10 @@ void generate_block(const BasicBlock& block,
     if (analysis.label_addresses.count(block.start_address)) {
         out << label(block.start_address) << ":\n";
     }
+    if (options.block_trace) {
+        out << "    CHIP8_TRACE_BLOCK(ctx, 0x" << std::hex << block.start_address << ");\n";
+    }
+    out << "    CHIP8_BREAKPOINT(ctx, 0x" << std::hex << block.start_address << ");\n";
     
     // Emit each instruction
     for (size_t idx : block.instruction_indices) {
@@ -422,40 +576,51 @@ void generate_function(const Function& func,
     
     out << "void " << func_name << "(Chip8Context* ctx) {\n";
     
-    // Collect all backward jump targets within THIS function
-    std::set<uint16_t> backward_jump_targets;
-    std::set<uint16_t> func_addresses;
+    // Collect all resume targets (backward jump targets, key wait returns) within THIS function
+    AddressSet resume_targets;
+    AddressSet func_addresses;
     
     // First, get all addresses that belong to this function
     for (uint16_t block_addr : func.block_addresses) {
-        if (!analysis.blocks.count(block_addr)) continue;
-        const auto& block = analysis.blocks.at(block_addr);
-        for (size_t idx : block.instruction_indices) {
+        const BasicBlock* block = analysis.blocks.find(block_addr);
+        if (!block) continue;
+        for (size_t idx : block->instruction_indices) {
             func_addresses.insert(analysis.instructions[idx].address);
         }
     }
     
+    // Only the entry function is re-entered after a yield: a key wait in a
+    // subroutine keeps running the frame
+    GeneratorOptions func_options = options;
+    func_options.key_wait_yield = options.key_wait_yield &&
+                                  func.entry_address == analysis.entry_point;
+    
     // Now find backward jumps within this function
     for (uint16_t block_addr : func.block_addresses) {
-        if (!analysis.blocks.count(block_addr)) continue;
-        const auto& block = analysis.blocks.at(block_addr);
-        for (size_t idx : block.instruction_indices) {
+        const BasicBlock* block = analysis.blocks.find(block_addr);
+        if (!block) continue;
+        for (size_t idx : block->instruction_indices) {
             const auto& instr = analysis.instructions[idx];
             if (instr.type == InstructionType::JP && instr.nnn <= instr.address) {
                 // Only add if the target is within this function
                 if (func_addresses.count(instr.nnn)) {
-                    backward_jump_targets.insert(instr.nnn);
+                    resume_targets.insert(instr.nnn);
                 }
             }
+            // Key waits resume at the next instruction
+            if (instr.type == InstructionType::LD_VX_K && func_options.key_wait_yield &&
+                func_addresses.count(instr.address + 2)) {
+                resume_targets.insert(instr.address + 2);
+            }
         }
     }
     
-    // Emit resume check at function start if there are backward jumps
-    if (!backward_jump_targets.empty()) {
+    // Emit resume check at function start if there are backward jumps or key waits
+    if (!resume_targets.empty()) {
         out << "    /* Resume from yield if needed */\n";
         out << "    if (ctx->should_yield) {\n";
         out << "        ctx->should_yield = false;\n";
-        for (uint16_t target : backward_jump_targets) {
+        for (uint16_t target : resume_targets) {
             out << "        if (ctx->resume_pc == 0x" << std::hex << target << ") goto " 
                 << label(target) << ";\n";
         }
@@ -465,139 +630,94 @@ void generate_function(const Function& func,
     // Sort blocks by address
     std::vector<uint16_t> sorted_addrs = func.block_addresses;
     std::sort(sorted_addrs.begin(), sorted_addrs.end());
+    AddressSet func_blocks(sorted_addrs.begin(), sorted_addrs.end());
+    
+    // Where each block falls through to, if it isn't the next block emitted
+    // (overlapping code, or code the function doesn't own)
+    auto fall_through = [&](size_t i) -> std::optional<uint16_t> {
+        const BasicBlock* block = analysis.blocks.find(sorted_addrs[i]);
+        if (!block || block->instruction_indices.empty()) return std::nullopt;
+        const auto& last = analysis.instructions[block->instruction_indices.back()];
+        if (last.is_terminator || last.is_return) return std::nullopt;
+        if (i + 1 < sorted_addrs.size() && sorted_addrs[i + 1] == block->end_address) {
+            return std::nullopt;
+        }
+        return block->end_address;
+    };
+    
+    AddressSet fall_through_labels;
+    for (size_t i = 0; i < sorted_addrs.size(); ++i) {
+        if (auto target = fall_through(i); target && func_blocks.contains(*target)) {
+            fall_through_labels.insert(*target);
+        }
+    }
     
-    for (uint16_t addr : sorted_addrs) {
-        if (!analysis.blocks.count(addr)) continue;
+    for (size_t i = 0; i < sorted_addrs.size(); ++i) {
+        uint16_t addr = sorted_addrs[i];
+        const BasicBlock* block = analysis.blocks.find(addr);
+        if (!block) continue;
         
-        const auto& block = analysis.blocks.at(addr);
-        generate_block(block, analysis.instructions, analysis, options, out);
+        if (fall_through_labels.contains(addr) && !analysis.label_addresses.contains(addr)) {
+            out << label(addr) << ":\n";
+        }
+        generate_block(*block, analysis.instructions, analysis, func_options, out);
+        
+        if (auto target = fall_through(i)) {
+            if (func_blocks.contains(*target)) {
+                out << "    goto " << label(*target) << ";\n";
+            } else if (const Function* next = analysis.functions.find(*target)) {
+                std::string next_name = options.use_prefixed_symbols
+                    ? options.output_prefix + "_" + next->name
+                    : next->name;
+                out << "    " << next_name << "(ctx); return;\n";
+            } else {
+                out << "    chip8_interp_run(ctx, 0x" << std::hex << *target << "); return;\n";
+            }
+        }
     }
     
     out << "}\n";
 }
 
 void generate_single_function(const AnalysisResult& analysis,
-                               const uint8_t* rom_data,
-                               size_t rom_size,
                                const GeneratorOptions& options,
-                               std::ostream& out) {
+                               std::ostream& out,
+                               AddressSet& code_addrs,
+                               AddressSet& resume_addrs) {
     out << "void " << options.output_prefix << "_main(Chip8Context* ctx) {\n";
     
-    const uint16_t base_address = 0x200;
-    
     // Determine prefix for symbols
     std::string prefix = options.use_prefixed_symbols ? options.output_prefix : "";
     auto label = [&prefix](uint16_t addr) { return generate_prefixed_label(addr, prefix); };
     
-    // Helper lambda to decode an instruction at any address (even or odd)
-    auto decode_at = [&](uint16_t addr) -> Instruction {
-        if (addr < base_address) {
-            Instruction instr{};
-            instr.address = addr;
-            instr.type = InstructionType::UNKNOWN;
-            return instr;
-        }
-        
-        size_t offset = addr - base_address;
-        if (offset + 1 >= rom_size) {
-            Instruction instr{};
-            instr.address = addr;
-            instr.type = InstructionType::UNKNOWN;
-            return instr;
-        }
-        
-        uint16_t opcode = (static_cast<uint16_t>(rom_data[offset]) << 8) | rom_data[offset + 1];
-        return decode_opcode(opcode, addr);
+    // === PASS 1: Code found by the analyzer's recursive descent ===
+    const AddressSet& reachable = analysis.address_space.instruction_starts;
+    auto instr_at = [&analysis](uint16_t addr) -> const Instruction& {
+        return analysis.instructions[analysis.address_space.index_of(addr)];
     };
     
-    // === PASS 1: Reachability analysis with on-the-fly decoding ===
-    std::map<uint16_t, Instruction> decoded_instrs;
-    std::set<uint16_t> reachable;
-    std::queue<uint16_t> worklist;
-    worklist.push(analysis.entry_point);
+    // === PASS 2: Collect metadata from reachable instructions ===
+    AddressSet return_addresses;
+    AddressSet needed_labels;
+    AddressMap<AddressSet> computed_jump_targets; // base_addr -> possible targets
     
-    while (!worklist.empty()) {
-        uint16_t addr = worklist.front();
-        worklist.pop();
-        
-        if (reachable.count(addr)) continue;
-        if (addr < base_address || (addr - base_address) + 1 >= rom_size) continue;
-        
-        // Decode on-the-fly
-        Instruction instr = decode_at(addr);
-        
-        // Skip data sections
-        if (instr.type == InstructionType::UNKNOWN) continue;
-        if (instr.type == InstructionType::SYS && instr.opcode != 0x00E0 && instr.opcode != 0x00EE) continue;
-        
-        reachable.insert(addr);
-        decoded_instrs[addr] = instr;
-        
-        // Determine successors
-        switch (instr.type) {
-            case InstructionType::JP:
-                worklist.push(instr.nnn);
-                break;
-                
-            case InstructionType::CALL:
-                worklist.push(instr.nnn);  // Called function
-                worklist.push(addr + 2);   // Return address
-                break;
-                
-            case InstructionType::RET:
-                // No static successors
-                break;
-                
-            case InstructionType::JP_V0:
-                // Computed jump - try to cover a range
-                for (uint16_t offset = 0; offset < 32; offset += 2) {
-                    if ((instr.nnn + offset) >= base_address) {
-                        worklist.push(instr.nnn + offset);
-                    }
-                }
-                break;
-                
-            case InstructionType::SE_VX_NN:
-            case InstructionType::SNE_VX_NN:
-            case InstructionType::SE_VX_VY:
-            case InstructionType::SNE_VX_VY:
-            case InstructionType::SKP:
-            case InstructionType::SKNP:
-                // Skip instructions: both paths
-                worklist.push(addr + 2);  // Not skipped
-                worklist.push(addr + 4);  // Skipped
-                break;
-                
-            default:
-                // Sequential instruction
-                worklist.push(addr + 2);
-                break;
-        }
-    }
+    // The entry starts a block too (block hooks are emitted at labels)
+    needed_labels.insert(analysis.entry_point);
     
-    // === PASS 2: Collect metadata from reachable instructions ===
-    std::set<uint16_t> backward_jump_targets;
-    std::set<uint16_t> return_addresses;
-    std::set<uint16_t> needed_labels;
-    std::map<uint16_t, std::set<uint16_t>> computed_jump_targets; // base_addr -> possible targets
-    
-    for (const auto& [addr, instr] : decoded_instrs) {
-        // Backward jump targets need yield support
-        if (instr.type == InstructionType::JP && instr.nnn <= addr) {
-            backward_jump_targets.insert(instr.nnn);
-        }
+    for (const Instruction& instr : analysis.instructions) {
+        uint16_t addr = instr.address;
         
-        // Collect return addresses for CALL dispatch
-        if (instr.type == InstructionType::CALL) {
+        // Collect return addresses for CALL dispatch (others go to the interpreter)
+        if (instr.type == InstructionType::CALL && reachable.count(addr + 2)) {
             return_addresses.insert(addr + 2);
         }
         
         // Collect computed jump targets for JP_V0 dispatch
         if (instr.type == InstructionType::JP_V0) {
-            // Generate possible targets (V0 can be 0-255, but typically small range)
-            for (uint16_t offset = 0; offset < 64; offset += 2) {
+            // Probe the entries the analyzer discovered; others reach the interpreter
+            for (uint16_t offset = 0; offset < JUMP_TABLE_ENTRIES * 2; offset += 2) {
                 uint16_t target = instr.nnn + offset;
-                if (reachable.count(target) || decoded_instrs.count(target)) {
+                if (reachable.count(target)) {
                     computed_jump_targets[instr.nnn].insert(target);
                     needed_labels.insert(target);
                 }
@@ -613,6 +733,9 @@ void generate_single_function(const AnalysisResult& analysis,
                 needed_labels.insert(instr.nnn);
                 needed_labels.insert(addr + 2);  // Return point
                 break;
+            case InstructionType::LD_VX_K:
+                needed_labels.insert(addr + 2);  // Resume point after the key wait
+                break;
             case InstructionType::SE_VX_NN:
             case InstructionType::SNE_VX_NN:
             case InstructionType::SE_VX_VY:
@@ -627,33 +750,65 @@ void generate_single_function(const AnalysisResult& analysis,
         }
     }
     
+    // Instructions that fall through to something other than the next one
+    // emitted (overlapping code at the other alignment, or data) need an
+    // explicit jump
+    auto falls_through = [](const Instruction& instr) {
+        return instr.type != InstructionType::JP &&
+               instr.type != InstructionType::JP_V0 &&
+               instr.type != InstructionType::RET &&
+               instr.type != InstructionType::CALL;
+    };
+    auto next_emitted = [&reachable](uint16_t addr) {
+        return reachable.next_from(static_cast<size_t>(addr) + 1);
+    };
+    for (uint16_t addr : reachable) {
+        uint16_t next = addr + 2;
+        if (falls_through(instr_at(addr)) && next_emitted(addr) != next && reachable.count(next)) {
+            needed_labels.insert(next);
+        }
+    }
+    
     // === PASS 3: Emit code ===
     
-    // Emit resume check for backward jumps
-    if (!backward_jump_targets.empty()) {
-        out << "    /* Resume from yield if needed */\n";
-        out << "    if (ctx->should_yield) {\n";
-        out << "        ctx->should_yield = false;\n";
-        for (uint16_t target : backward_jump_targets) {
-            out << "        if (ctx->resume_pc == 0x" << std::hex << target << ") goto " 
-                << label(target) << ";\n";
+    // Every emitted label is a re-entry point: yields resume at backward jump
+    // targets, and the fallback interpreter hands back at the first label it
+    // reaches whose code is unmodified
+    code_addrs = reachable;
+    for (uint16_t addr : needed_labels) {
+        if (reachable.count(addr)) {
+            resume_addrs.insert(addr);
         }
-        out << "    }\n\n";
     }
     
-    // Get sorted list of reachable addresses
-    std::vector<uint16_t> sorted_addrs(reachable.begin(), reachable.end());
-    std::sort(sorted_addrs.begin(), sorted_addrs.end());
+    // Emit resume dispatch
+    out << "    /* Resume from yield or interpreter hand-back */\n";
+    out << "    if (ctx->should_yield) {\n";
+    out << "dispatch:\n";
+    out << "        ctx->should_yield = false;\n";
+    out << "        switch (ctx->resume_pc) {\n";
+    for (uint16_t target : resume_addrs) {
+        out << "            case 0x" << std::hex << target << ": goto " 
+            << label(target) << ";\n";
+    }
+    out << "            default: CHIP8_INTERP_HANDOFF(ctx, ctx->resume_pc, dispatch);\n";
+    out << "        }\n";
+    out << "    }\n\n";
     
-    std::set<uint16_t> emitted_labels;
+    // Reachable addresses iterate in ascending order
+    AddressSet emitted_labels;
     
-    for (uint16_t addr : sorted_addrs) {
-        const Instruction& instr = decoded_instrs[addr];
+    for (uint16_t addr : reachable) {
+        const Instruction& instr = instr_at(addr);
         
-        // Emit label if needed
+        // Emit label if needed; every label starts a block
         if (needed_labels.count(addr) && !emitted_labels.count(addr)) {
             out << label(addr) << ":\n";
             emitted_labels.insert(addr);
+            if (options.block_trace) {
+                out << "    CHIP8_TRACE_BLOCK(ctx, 0x" << std::hex << addr << ");\n";
+            }
+            out << "    CHIP8_BREAKPOINT(ctx, 0x" << std::hex << addr << ");\n";
         }
         
         // Special handling for CALL, RET, and JP_V0 in single-function mode
@@ -671,7 +826,7 @@ void generate_single_function(const AnalysisResult& analysis,
                 out << "            case 0x" << std::hex << ret_addr << ": goto " 
                     << label(ret_addr) << ";\n";
             }
-            out << "            default: return; /* Unknown return address */\n";
+            out << "            default: CHIP8_INTERP_HANDOFF(ctx, ret_addr, dispatch);\n";
             out << "        }\n";
             out << "    }\n";
         } else if (instr.type == InstructionType::JP_V0) {
@@ -680,18 +835,27 @@ void generate_single_function(const AnalysisResult& analysis,
             out << "    {\n";
             out << "        uint16_t target = 0x" << std::hex << instr.nnn << " + ctx->V[0];\n";
             out << "        switch (target) {\n";
-            if (computed_jump_targets.count(instr.nnn)) {
-                for (uint16_t target : computed_jump_targets[instr.nnn]) {
+            if (const AddressSet* targets = computed_jump_targets.find(instr.nnn)) {
+                for (uint16_t target : *targets) {
                     out << "            case 0x" << std::hex << target << ": goto " 
                         << label(target) << ";\n";
                 }
             }
-            out << "            default: chip8_panic(\"Invalid computed jump target\", target); return;\n";
+            out << "            default: CHIP8_INTERP_HANDOFF(ctx, target, dispatch);\n";
             out << "        }\n";
             out << "    }\n";
         } else {
             // Normal instruction handling
             generate_instruction(instr, options, out);
+            
+            uint16_t next = addr + 2;
+            if (falls_through(instr) && next_emitted(addr) != next) {
+                if (reachable.count(next)) {
+                    out << "    goto " << label(next) << ";\n";
+                } else {
+                    out << "    CHIP8_INTERP_HANDOFF(ctx, 0x" << std::hex << next << ", dispatch);\n";
+                }
+            }
         }
     }
     
@@ -784,8 +948,10 @@ std::string generate_main(const GeneratorOptions& options) {
     main << "    int headless_frames = 0;\n";
     main << "    const char* dump_file = NULL;\n";
     main << "    const char* compare_file = NULL;\n";
+    main << "    const char* trace_file = NULL;\n";
     main << "    bool dump_display = false;\n";
-    main << "    bool dump_hash = false;\n\n";
+    main << "    bool dump_hash = false;\n";
+    main << "    bool lockstep = false;\n\n";
     
     main << "    /* Parse command line arguments */\n";
     main << "    for (int i = 1; i < argc; i++) {\n";
@@ -799,6 +965,10 @@ std::string generate_main(const GeneratorOptions& options) {
     main << "            dump_file = argv[++i];\n";
     main << "        } else if (strcmp(argv[i], \"--compare\") == 0 && i + 1 < argc) {\n";
     main << "            compare_file = argv[++i];\n";
+    main << "        } else if (strcmp(argv[i], \"--lockstep\") == 0) {\n";
+    main << "            lockstep = true;\n";
+    main << "        } else if (strcmp(argv[i], \"--trace\") == 0 && i + 1 < argc) {\n";
+    main << "            trace_file = argv[++i];\n";
     main << "        }\n";
     main << "    }\n\n";
     
@@ -827,6 +997,8 @@ std::string generate_main(const GeneratorOptions& options) {
     main << "    if (headless_frames > 0) {\n";
     main << "        config.max_frames = headless_frames;\n";
     main << "    }\n\n";
+    main << "    config.lockstep = lockstep;\n";
+    main << "    config.trace_file = trace_file;\n\n";
     
     main << "    /* Run the recompiled program */\n";
     main << "    int result = chip8_run(" << options.output_prefix << "_entry, &config);\n\n";
@@ -846,7 +1018,7 @@ std::string generate_main(const GeneratorOptions& options) {
     main << "        if (compare_file && ctx) {\n";
     main << "            if (chip8_compare_display_pbm(ctx, compare_file)) {\n";
     main << "                printf(\"DISPLAY_MATCH: PASS\\n\");\n";
-    main << "                return 0;\n";
+    main << "                return result;\n";
     main << "            } else {\n";
     main << "                printf(\"DISPLAY_MATCH: FAIL\\n\");\n";
     main << "                return 1;\n";
@@ -860,7 +1032,8 @@ std::string generate_main(const GeneratorOptions& options) {
     return main.str();
 }
 
-std::string generate_cmake(const GeneratorOptions& options) {
+std::string generate_cmake(const GeneratorOptions& options,
+                           const std::vector<std::string>& function_files) {
     std::ostringstream cmake;
     
     cmake << "# Auto-generated CMakeLists.txt for " << options.output_prefix << "\n";
@@ -872,6 +1045,8 @@ std::string generate_cmake(const GeneratorOptions& options) {
     cmake << "set(CMAKE_C_STANDARD 11)\n";
     cmake << "set(CMAKE_CXX_STANDARD 17)\n\n";
     
+    cmake << generate_cmake_build_settings();
+    
     cmake << "# Find SDL2\n";
     cmake << "find_package(SDL2 REQUIRED)\n\n";
     
@@ -891,6 +1066,9 @@ std::string generate_cmake(const GeneratorOptions& options) {
     cmake << "set(SOURCES\n";
     cmake << "    main.c\n";
     cmake << "    " << options.output_prefix << ".c\n";
+    for (const auto& file : function_files) {
+        cmake << "    " << file << "\n";
+    }
     if (options.embed_rom_data) {
         cmake << "    rom_data.c\n";
     }
@@ -900,6 +1078,14 @@ std::string generate_cmake(const GeneratorOptions& options) {
     cmake << "set(RUNTIME_SOURCES\n";
     cmake << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/context.c\n";
     cmake << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/instructions.c\n";
+    cmake << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/audio.c\n";
+    cmake << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/idle.c\n";
+    cmake << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/pacer.c\n";
+    cmake << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/debugger.c\n";
+    cmake << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/disasm.c\n";
+    cmake << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/interpreter.c\n";
+    cmake << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/lockstep.c\n";
+    cmake << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/trace.c\n";
     cmake << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/runtime.c\n";
     cmake << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/platform_sdl.c\n";
     cmake << "    ${CHIP8_RECOMPILED_DIR}/runtime/src/platform_headless.c\n";
@@ -934,6 +1120,109 @@ std::string generate_cmake(const GeneratorOptions& options) {
     return cmake.str();
 }
 
+std::string generate_cmake_build_settings() {
+    std::ostringstream cmake;
+    
+    cmake << "# Default to an optimized build\n";
+    cmake << "if(NOT CMAKE_BUILD_TYPE AND NOT CMAKE_CONFIGURATION_TYPES)\n";
+    cmake << "    set(CMAKE_BUILD_TYPE Release CACHE STRING \"Build type\" FORCE)\n";
+    cmake << "endif()\n\n";
+    
+    cmake << "# Link-time optimization across the recompiled code and the runtime, so\n";
+    cmake << "# helpers like chip8_draw_sprite can inline into generated blocks\n";
+    cmake << "option(CHIP8_ENABLE_LTO \"Enable link-time optimization for optimized builds\" ON)\n";
+    cmake << "if(CHIP8_ENABLE_LTO)\n";
+    cmake << "    include(CheckIPOSupported)\n";
+    cmake << "    check_ipo_supported(RESULT CHIP8_IPO_SUPPORTED OUTPUT CHIP8_IPO_ERROR LANGUAGES C CXX)\n";
+    cmake << "    if(CHIP8_IPO_SUPPORTED)\n";
+    cmake << "        set(CMAKE_INTERPROCEDURAL_OPTIMIZATION_RELEASE ON)\n";
+    cmake << "        set(CMAKE_INTERPROCEDURAL_OPTIMIZATION_RELWITHDEBINFO ON)\n";
+    cmake << "    else()\n";
+    cmake << "        message(STATUS \"LTO not supported: ${CHIP8_IPO_ERROR}\")\n";
+    cmake << "    endif()\n";
+    cmake << "endif()\n\n";
+    
+    cmake << "# The runtime's sound event ring uses C11 atomics\n";
+    cmake << "if(MSVC)\n";
+    cmake << "    add_compile_options($<$<COMPILE_LANGUAGE:C>:/std:c11>\n";
+    cmake << "                        $<$<COMPILE_LANGUAGE:C>:/experimental:c11atomics>)\n";
+    cmake << "endif()\n\n";
+    
+    cmake << "# Instrumentation-based profile-guided optimization:\n";
+    cmake << "#   1. configure with CHIP8_PGO=GENERATE, build and play\n";
+    cmake << "#   2. Clang: llvm-profdata merge -o <CHIP8_PGO_PROFILE> *.profraw\n";
+    cmake << "#   3. reconfigure with CHIP8_PGO=USE and rebuild\n";
+    cmake << "set(CHIP8_PGO OFF CACHE STRING \"Profile-guided optimization phase (OFF, GENERATE, USE)\")\n";
+    cmake << "set_property(CACHE CHIP8_PGO PROPERTY STRINGS OFF GENERATE USE)\n";
+    cmake << "set(CHIP8_PGO_PROFILE \"${CMAKE_SOURCE_DIR}/pgo/chip8.profdata\" CACHE FILEPATH\n";
+    cmake << "    \"Merged .profdata file (Clang) read by CHIP8_PGO=USE\")\n";
+    cmake << "set(CHIP8_PGO_DIR \"${CMAKE_SOURCE_DIR}/pgo\" CACHE PATH\n";
+    cmake << "    \"Directory for raw profiles (.profraw for Clang, .gcda for GCC)\")\n";
+    cmake << "set(CHIP8_PGO_GCC_FLAGS -fprofile-dir=${CHIP8_PGO_DIR})\n";
+    cmake << "if(CMAKE_C_COMPILER_ID STREQUAL \"GNU\" AND CMAKE_C_COMPILER_VERSION VERSION_GREATER_EQUAL 12)\n";
+    cmake << "    # Name .gcda files independently of the build directory so the\n";
+    cmake << "    # pgo-generate and pgo-use presets can share them\n";
+    cmake << "    list(APPEND CHIP8_PGO_GCC_FLAGS -fprofile-prefix-path=${CMAKE_BINARY_DIR})\n";
+    cmake << "endif()\n";
+    cmake << "if(CHIP8_PGO STREQUAL \"GENERATE\")\n";
+    cmake << "    if(CMAKE_C_COMPILER_ID MATCHES \"Clang\")\n";
+    cmake << "        add_compile_options(-fprofile-instr-generate=${CHIP8_PGO_DIR}/%p.profraw)\n";
+    cmake << "        add_link_options(-fprofile-instr-generate=${CHIP8_PGO_DIR}/%p.profraw)\n";
+    cmake << "    elseif(CMAKE_C_COMPILER_ID STREQUAL \"GNU\")\n";
+    cmake << "        add_compile_options(-fprofile-generate ${CHIP8_PGO_GCC_FLAGS})\n";
+    cmake << "        add_link_options(-fprofile-generate)\n";
+    cmake << "    endif()\n";
+    cmake << "elseif(CHIP8_PGO STREQUAL \"USE\")\n";
+    cmake << "    if(CMAKE_C_COMPILER_ID MATCHES \"Clang\")\n";
+    cmake << "        add_compile_options(-fprofile-instr-use=${CHIP8_PGO_PROFILE})\n";
+    cmake << "        add_link_options(-fprofile-instr-use=${CHIP8_PGO_PROFILE})\n";
+    cmake << "    elseif(CMAKE_C_COMPILER_ID STREQUAL \"GNU\")\n";
+    cmake << "        add_compile_options(-fprofile-use ${CHIP8_PGO_GCC_FLAGS} -Wno-missing-profile)\n";
+    cmake << "    endif()\n";
+    cmake << "endif()\n\n";
+    
+    return cmake.str();
+}
+
+std::string generate_cmake_presets() {
+    std::ostringstream json;
+    
+    auto preset = [&json](const std::string& name, const std::string& display,
+                          const std::string& build_type, const std::string& pgo, bool last) {
+        json << "    {\n";
+        json << "      \"name\": \"" << name << "\",\n";
+        json << "      \"displayName\": \"" << display << "\",\n";
+        json << "      \"generator\": \"Ninja\",\n";
+        json << "      \"binaryDir\": \"${sourceDir}/build/" << name << "\",\n";
+        json << "      \"cacheVariables\": {\n";
+        json << "        \"CMAKE_BUILD_TYPE\": \"" << build_type << "\",\n";
+        json << "        \"CHIP8_ENABLE_LTO\": \"ON\",\n";
+        json << "        \"CHIP8_PGO\": \"" << pgo << "\"\n";
+        json << "      }\n";
+        json << "    }" << (last ? "" : ",") << "\n";
+    };
+    
+    json << "{\n";
+    json << "  \"version\": 2,\n";
+    json << "  \"cmakeMinimumRequired\": { \"major\": 3, \"minor\": 20, \"patch\": 0 },\n";
+    json << "  \"configurePresets\": [\n";
+    preset("release", "Release (LTO)", "Release", "OFF", false);
+    preset("relwithdebinfo", "RelWithDebInfo (LTO)", "RelWithDebInfo", "OFF", false);
+    preset("pgo-generate", "PGO: instrumented build", "Release", "GENERATE", false);
+    preset("pgo-use", "PGO: optimized with profile", "Release", "USE", true);
+    json << "  ],\n";
+    json << "  \"buildPresets\": [\n";
+    const char* names[] = {"release", "relwithdebinfo", "pgo-generate", "pgo-use"};
+    for (size_t i = 0; i < 4; ++i) {
+        json << "    { \"name\": \"" << names[i] << "\", \"configurePreset\": \"" 
+             << names[i] << "\" }" << (i < 3 ? "," : "") << "\n";
+    }
+    json << "  ]\n";
+    json << "}\n";
+    
+    return json.str();
+}
+
 std::string generate_rom_data(const uint8_t* rom_data,
                                size_t rom_size,
                                const GeneratorOptions& options) {
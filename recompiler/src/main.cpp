@@ -12,7 +12,9 @@
 #include "recompiler/config.h"
 #include "recompiler/batch.h"
 
+#include <cstdlib>
 #include <iostream>
+#include <iomanip>
 #include <string>
 #include <filesystem>
 
@@ -31,13 +33,54 @@ void print_usage(const char* program_name) {
     std::cout << "  --no-comments          Don't emit disassembly comments\n";
     std::cout << "  --single-function      Use single-function mode (for complex ROMs)\n";
     std::cout << "  --no-auto              Disable auto mode (don't fallback to single-function)\n";
+    std::cout << "  --no-smc-guard         Don't track self-modifying code at runtime\n";
+    std::cout << "  --no-idle-loops        Run DT/key wait loops instruction by instruction\n";
+    std::cout << "  --split <n>            Split functions into .c files of n functions each\n";
     std::cout << "  --debug                Enable debug output\n";
+    std::cout << "  --block-trace          Record executed blocks for the debug overlay\n";
     std::cout << "  --disasm               Print disassembly and exit\n";
     std::cout << "  -h, --help             Show this help message\n";
     std::cout << "\nBatch mode uses auto-mode by default: tries regular compilation first,\n";
     std::cout << "falls back to single-function mode if compilation would fail.\n";
 }
 
+// Print discovered code in address order, with data bytes as DB lines
+void print_disassembly(const chip8recomp::AnalysisResult& analysis,
+                       const uint8_t* rom_data, size_t rom_size) {
+    const uint16_t base_address = 0x200;
+    const auto& space = analysis.address_space;
+    
+    size_t offset = 0;
+    while (offset < rom_size) {
+        uint16_t addr = static_cast<uint16_t>(base_address + offset);
+        if (space.has_instruction(addr)) {
+            const auto& instr = analysis.instructions[space.index_of(addr)];
+            std::cout << chip8recomp::disassemble(instr)
+                      << (instr.closes_idle_loop ? "  ; idle loop" : "") << "\n";
+        }
+        if (!analysis.data_bytes.contains(addr)) {
+            ++offset;
+            continue;
+        }
+        
+        // Up to 8 consecutive data bytes of one region per line
+        const chip8recomp::DataRegion* region = chip8recomp::find_data_region(analysis, addr);
+        std::cout << std::hex << std::uppercase << std::setfill('0')
+                  << std::setw(3) << addr << ": DB   ";
+        for (size_t n = 0; n < 8 && offset < rom_size; ++n, ++offset) {
+            uint16_t a = static_cast<uint16_t>(base_address + offset);
+            if (!analysis.data_bytes.contains(a)) break;
+            if (region && a >= region->end) break;
+            std::cout << (n ? ", " : "") << "0x" << std::setw(2) << (int)rom_data[offset];
+        }
+        std::cout << std::dec << std::setfill(' ');
+        if (region) {
+            std::cout << "  ; " << chip8recomp::data_kind_name(region->kind);
+        }
+        std::cout << "\n";
+    }
+}
+
 void print_banner() {
     std::cout << R"(
    ____ _   _ ___ ____  ___    ____                            _ _          _ 
@@ -64,9 +107,13 @@ int main(int argc, char* argv[]) {
     std::string metadata_file;
     bool emit_comments = true;
     bool debug_mode = false;
+    bool block_trace = false;
     bool disasm_only = false;
     bool single_function_mode = false;
+    bool smc_detection = true;
+    bool idle_loop_detection = true;
     bool batch_mode = false;
+    size_t functions_per_file = 0;  // 0 = single source file
     
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
@@ -109,10 +156,22 @@ int main(int argc, char* argv[]) {
             emit_comments = false;
         } else if (arg == "--debug") {
             debug_mode = true;
+        } else if (arg == "--block-trace") {
+            block_trace = true;
         } else if (arg == "--single-function") {
             single_function_mode = true;
         } else if (arg == "--no-auto") {
             /* Handled below when setting batch options */
+        } else if (arg == "--no-smc-guard") {
+            smc_detection = false;
+        } else if (arg == "--no-idle-loops") {
+            idle_loop_detection = false;
+        } else if (arg == "--split") {
+            if (++i >= argc || std::atoi(argv[i]) <= 0) {
+                std::cerr << "Error: --split requires a positive number\n";
+                return 1;
+            }
+            functions_per_file = static_cast<size_t>(std::atoi(argv[i]));
         } else if (arg == "--disasm") {
             disasm_only = true;
         } else if (arg[0] != '-') {
@@ -147,7 +206,14 @@ int main(int argc, char* argv[]) {
         // Set generator options
         batch_opts.gen_opts.emit_comments = emit_comments;
         batch_opts.gen_opts.debug_mode = debug_mode;
+        batch_opts.gen_opts.block_trace = block_trace;
         batch_opts.gen_opts.single_function_mode = single_function_mode;
+        batch_opts.gen_opts.smc_detection = smc_detection;
+        batch_opts.gen_opts.idle_loop_detection = idle_loop_detection;
+        if (functions_per_file > 0) {
+            batch_opts.gen_opts.use_single_file = false;
+            batch_opts.gen_opts.functions_per_file = functions_per_file;
+        }
         
         return chip8recomp::compile_batch(batch_opts);
     }
@@ -180,24 +246,20 @@ int main(int argc, char* argv[]) {
     chip8recomp::print_rom_info(*rom);
     std::cout << "\n";
     
-    // Decode instructions
-    std::cout << "Decoding instructions...\n";
-    auto instructions = chip8recomp::decode_rom(rom->bytes(), rom->size());
-    std::cout << "  Decoded " << instructions.size() << " instructions\n\n";
+    // Discover code and analyze control flow
+    std::cout << "Analyzing control flow...\n";
+    auto analysis = chip8recomp::analyze(rom->bytes(), rom->size());
+    std::cout << "  Discovered " << analysis.stats.total_instructions << " instructions ("
+              << analysis.stats.data_bytes << " data bytes)\n";
     
     // Disassembly only mode
     if (disasm_only) {
-        std::cout << "Disassembly:\n";
+        std::cout << "\nDisassembly:\n";
         std::cout << "============\n";
-        for (const auto& instr : instructions) {
-            std::cout << chip8recomp::disassemble(instr) << "\n";
-        }
+        print_disassembly(analysis, rom->bytes(), rom->size());
         return 0;
     }
     
-    // Analyze control flow
-    std::cout << "Analyzing control flow...\n";
-    auto analysis = chip8recomp::analyze(instructions);
     std::cout << "  Found " << analysis.stats.total_functions << " functions\n";
     std::cout << "  Found " << analysis.stats.total_blocks << " basic blocks\n";
     std::cout << "  " << analysis.label_addresses.size() << " labels needed\n\n";
@@ -214,7 +276,14 @@ int main(int argc, char* argv[]) {
     gen_opts.output_dir = output_dir;
     gen_opts.emit_comments = emit_comments;
     gen_opts.debug_mode = debug_mode;
+    gen_opts.block_trace = block_trace;
     gen_opts.single_function_mode = single_function_mode;
+    gen_opts.smc_detection = smc_detection;
+    gen_opts.idle_loop_detection = idle_loop_detection;
+    if (functions_per_file > 0) {
+        gen_opts.use_single_file = false;
+        gen_opts.functions_per_file = functions_per_file;
+    }
     
     if (single_function_mode) {
         std::cout << "  Using single-function mode\n";
@@ -237,18 +306,21 @@ int main(int argc, char* argv[]) {
     std::cout << "\nGenerated files:\n";
     std::cout << "  " << (out_path / output.header_file) << "\n";
     std::cout << "  " << (out_path / output.source_file) << "\n";
+    for (const auto& source : output.function_sources) {
+        std::cout << "  " << (out_path / source.file) << "\n";
+    }
     std::cout << "  " << (out_path / output.main_file) << "\n";
     std::cout << "  " << (out_path / output.cmake_file) << "\n";
+    std::cout << "  " << (out_path / output.presets_file) << "\n";
     if (gen_opts.embed_rom_data) {
         std::cout << "  " << (out_path / output.rom_data_file) << "\n";
     }
     
     std::cout << "\nBuild instructions:\n";
     std::cout << "  cd " << out_path << "\n";
-    std::cout << "  mkdir build && cd build\n";
-    std::cout << "  cmake -G Ninja ..\n";
-    std::cout << "  cmake --build .\n";
-    std::cout << "  ./" << rom_name << "\n";
+    std::cout << "  cmake --preset release\n";
+    std::cout << "  cmake --build --preset release\n";
+    std::cout << "  ./build/release/" << rom_name << "\n";
     
     return 0;
 }
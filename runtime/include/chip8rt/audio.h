@@ -0,0 +1,185 @@
+/**
+ * @file audio.h
+ * @brief Timestamped sound events and sample-accurate beeper rendering
+ *
+ * The CPU side records every change to the sound output - the sound timer
+ * starting or running out, XO-CHIP pitch (FX3A) and pattern (F002) writes -
+ * as an event stamped with the frame and cycle it happened at. Events pass
+ * through a single-producer/single-consumer lock-free ring to the audio
+ * callback, which replays them at the matching sample position one buffer
+ * behind the CPU. Tones therefore start and stop mid-frame, and the output
+ * no longer toggles at 60 Hz frame boundaries.
+ *
+ * Platforms opt in through Chip8Platform::audio_attach; without it the
+ * runtime keeps calling beep_start/beep_stop once per frame.
+ */
+
+#ifndef CHIP8RT_AUDIO_H
+#define CHIP8RT_AUDIO_H
+
+#include "context.h"
+#include "settings.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Events the ring can hold (power of two) */
+#define CHIP8_AUDIO_RING_SIZE       256
+
+/** Playback drift, in frames, beyond which the renderer resynchronizes */
+#define CHIP8_AUDIO_MAX_DRIFT       4.0
+
+/** XO-CHIP playback rate at the default pitch (samples per second) */
+#define CHIP8_AUDIO_PATTERN_RATE    4000.0
+
+/* ============================================================================
+ * Events
+ * ========================================================================== */
+
+/**
+ * @brief Kind of sound change
+ */
+typedef enum Chip8AudioEventType {
+    CHIP8_AUDIO_EVENT_TONE,     /* Sound timer became non-zero or zero */
+    CHIP8_AUDIO_EVENT_PITCH,    /* FX3A set the pattern pitch */
+    CHIP8_AUDIO_EVENT_PATTERN,  /* F002 loaded a 16-byte pattern */
+    CHIP8_AUDIO_EVENT_RESET     /* Machine reset: silence, default pitch, no pattern */
+} Chip8AudioEventType;
+
+/**
+ * @brief A sound change at a point in emulated time
+ */
+typedef struct Chip8AudioEvent {
+    /** Frame the change happened in */
+    uint64_t frame;
+
+    /** Cycles into the frame, out of frame_cycles */
+    uint16_t cycle;
+    uint16_t frame_cycles;
+
+    /** Chip8AudioEventType */
+    uint8_t type;
+
+    /** Tone on (1) or off (0), or the pitch register */
+    uint8_t value;
+
+    /** Pattern bits, most significant bit of byte 0 first */
+    uint8_t pattern[CHIP8_AUDIO_PATTERN_SIZE];
+} Chip8AudioEvent;
+
+/* ============================================================================
+ * Event Ring (CPU thread -> audio thread)
+ * ========================================================================== */
+
+typedef struct Chip8AudioRing Chip8AudioRing;
+
+/**
+ * @brief Create an empty ring
+ *
+ * @return New ring, or NULL on allocation failure
+ */
+Chip8AudioRing* chip8_audio_ring_create(void);
+
+/**
+ * @brief Destroy a ring (safe to pass NULL)
+ *
+ * The consumer must have stopped reading from it.
+ */
+void chip8_audio_ring_destroy(Chip8AudioRing* ring);
+
+/**
+ * @brief Start recording a frame
+ *
+ * Events recorded until chip8_audio_end_frame() are stamped with this
+ * frame and their position in its cycle budget.
+ *
+ * @param ring Event ring
+ * @param cycles Cycle budget of the frame
+ */
+void chip8_audio_begin_frame(Chip8AudioRing* ring, int cycles);
+
+/**
+ * @brief Finish a frame and make its events playable
+ *
+ * @param ring Event ring
+ */
+void chip8_audio_end_frame(Chip8AudioRing* ring);
+
+/**
+ * @brief Record the current sound state of a context
+ *
+ * Stamps the event at the context's position in the current frame and
+ * fills it from ctx (sound_timer, audio_pitch, audio_pattern). Does
+ * nothing when the context has no ring. Drops the event if the ring is
+ * full.
+ *
+ * @param ctx CHIP-8 context
+ * @param type What changed
+ */
+void chip8_audio_record(Chip8Context* ctx, Chip8AudioEventType type);
+
+/* ============================================================================
+ * Renderer (audio thread)
+ * ========================================================================== */
+
+/**
+ * @brief Sound settings the renderer reads for the plain beeper
+ */
+typedef struct Chip8AudioVoice {
+    Chip8Waveform waveform;
+    int frequency;      /* Hz */
+    float volume;       /* 0.0 - 1.0, 0 when muted */
+} Chip8AudioVoice;
+
+/**
+ * @brief Playback state owned by the audio callback
+ */
+typedef struct Chip8AudioRenderer {
+    /** Current output state, as of the last applied event */
+    bool tone;
+    bool has_pattern;
+    uint8_t pattern[CHIP8_AUDIO_PATTERN_SIZE];
+    double pattern_rate;
+
+    /** Playback position in emulated frames (follows the ring one buffer behind) */
+    double position;
+    bool synced;
+
+    /** Oscillator state */
+    float phase;
+    double pattern_phase;
+    uint32_t noise;
+
+    /** Event read from the ring but not yet due */
+    Chip8AudioEvent pending;
+    bool has_pending;
+} Chip8AudioRenderer;
+
+/**
+ * @brief Initialize a renderer to silence
+ */
+void chip8_audio_renderer_init(Chip8AudioRenderer* renderer);
+
+/**
+ * @brief Render mono float samples from the ring
+ *
+ * Applies each event at the sample its timestamp maps to. Plays the XO-CHIP
+ * pattern once one has been loaded and the voice's waveform otherwise.
+ *
+ * @param renderer Playback state
+ * @param ring Event ring (NULL renders silence)
+ * @param voice Waveform, frequency and volume
+ * @param out Output samples
+ * @param samples Number of samples
+ * @param sample_rate Output sample rate in Hz
+ */
+void chip8_audio_render(Chip8AudioRenderer* renderer, Chip8AudioRing* ring,
+                        const Chip8AudioVoice* voice,
+                        float* out, int samples, int sample_rate);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CHIP8RT_AUDIO_H */
@@ -60,6 +60,30 @@ extern "C" {
 /** Target CPU cycles per second (approximate) */
 #define CHIP8_CPU_FREQ_HZ       700
 
+/** Size of a per-address bitmap over memory (one bit per byte, plus padding) */
+#define CHIP8_CODE_MAP_SIZE     (CHIP8_MEMORY_SIZE / 8 + 4)
+
+/** Granularity of self-modifying code tracking */
+#define CHIP8_SMC_PAGE_SIZE     32
+
+/** Number of tracked pages */
+#define CHIP8_SMC_NUM_PAGES     (CHIP8_MEMORY_SIZE / CHIP8_SMC_PAGE_SIZE)
+
+/** Entries in the block trace ring (power of two) */
+#define CHIP8_BLOCK_TRACE_SIZE  64
+
+/** Cache line size assumed for the context's hot header */
+#define CHIP8_CACHE_LINE_SIZE   64
+
+/** Size of the XO-CHIP audio pattern buffer (128 one-bit samples) */
+#define CHIP8_AUDIO_PATTERN_SIZE 16
+
+/** XO-CHIP pitch register value for a 4000 Hz pattern playback rate */
+#define CHIP8_AUDIO_DEFAULT_PITCH 64
+
+/** Random number generator state used when none has been seeded */
+#define CHIP8_RNG_DEFAULT_STATE 0x12345678u
+
 /* ============================================================================
  * CPU Context Structure
  * ========================================================================== */
@@ -69,9 +93,16 @@ extern "C" {
  * 
  * Contains all CPU registers, memory, display buffer, and runtime state.
  * This structure is passed to all recompiled functions.
+ * 
+ * Fields are ordered by how often recompiled code touches them. Everything
+ * read or written between yields (registers, timers, the cycle budget and
+ * yield flags, the SMC watch map) sits in the first CHIP8_CACHE_LINE_SIZE
+ * bytes, so the yield check shares a cache line with V and I. The stack,
+ * memory and display follow at fixed offsets; input, platform and debug
+ * state come last.
  */
 typedef struct Chip8Context {
-    /* === Registers === */
+    /* === Hot Header: Registers === */
     
     /** General-purpose registers V0-VF (VF is the flag register) */
     uint8_t V[CHIP8_NUM_REGISTERS];
@@ -79,28 +110,66 @@ typedef struct Chip8Context {
     /** Index register (12-bit, used for memory addresses) */
     uint16_t I;
     
-    /** Program counter (unused in recompiled code, kept for debugging) */
+    /** Program counter: start of the current block with block tracing, else unused */
     uint16_t PC;
     
     /** Stack pointer (0-15) */
     uint8_t SP;
     
-    /* === Timers === */
-    
     /** Delay timer - decremented at 60Hz, read/write accessible */
     uint8_t delay_timer;
     
     /** Sound timer - decremented at 60Hz, beep when > 0 */
     uint8_t sound_timer;
     
-    /* === Memory === */
+    /* === Hot Header: Yielding Support === */
     
-    /** Main memory (4KB) - contains font, program, and working RAM */
-    uint8_t memory[CHIP8_MEMORY_SIZE];
+    /** Flag indicating we should yield back to main loop */
+    bool should_yield;
+    
+    /** Cycles remaining in current frame (for cooperative yielding) */
+    int cycles_remaining;
+    
+    /** Program counter to resume from after yield */
+    uint16_t resume_pc;
+    
+    /** Execution belongs to the fallback interpreter (resume_pc is its PC) */
+    bool in_interpreter;
+    
+    /** Set by store helpers when a write modified recompiled code */
+    bool smc_pending;
+    
+    /** Random number generator state for CXNN (xorshift32, never 0) */
+    uint32_t rng_state;
+    
+    /** Flag indicating the program should continue running */
+    bool running;
+    
+    /** Flag indicating CPU is blocked waiting for a key press (FX0A) */
+    bool waiting_for_key;
+    
+    /** Register index to store key value when waiting */
+    uint8_t key_wait_register;
+    
+    /** Flag indicating display needs to be redrawn */
+    bool display_dirty;
+    
+    /** The frame ended early in an idle loop (CHIP8_IDLE_YIELD) */
+    bool idle;
+    
+    /** Bitmap of addresses whose stores must be reported: recompiled and cached code (NULL = none) */
+    const uint8_t* watch_map;
+    
+    /* === Stack === */
     
     /** Call stack for subroutine return addresses */
     uint16_t stack[CHIP8_STACK_SIZE];
     
+    /* === Memory === */
+    
+    /** Main memory (4KB) - contains font, program, and working RAM */
+    uint8_t memory[CHIP8_MEMORY_SIZE];
+    
     /* === Display === */
     
     /** 
@@ -110,9 +179,6 @@ typedef struct Chip8Context {
      */
     uint8_t display[CHIP8_DISPLAY_SIZE];
     
-    /** Flag indicating display needs to be redrawn */
-    bool display_dirty;
-    
     /* === Input === */
     
     /** Current key state (true = pressed) for keys 0x0-0xF */
@@ -124,33 +190,30 @@ typedef struct Chip8Context {
     /** Key that was just released (for FX0A wait instruction) */
     int8_t last_key_released;
     
-    /* === Runtime State === */
-    
-    /** Flag indicating the program should continue running */
-    bool running;
-    
-    /** Flag indicating CPU is blocked waiting for a key press (FX0A) */
-    bool waiting_for_key;
+    /* === Audio === */
     
-    /** Register index to store key value when waiting */
-    uint8_t key_wait_register;
+    /** XO-CHIP pitch register (FX3A) */
+    uint8_t audio_pitch;
     
-    /* === Yielding Support === */
+    /** XO-CHIP audio pattern buffer (F002) */
+    uint8_t audio_pattern[CHIP8_AUDIO_PATTERN_SIZE];
     
-    /** Cycles remaining in current frame (for cooperative yielding) */
-    int cycles_remaining;
+    /** Sound event ring read by the platform's audio callback (NULL = beep_start/stop only) */
+    struct Chip8AudioRing* audio_ring;
     
-    /** Program counter to resume from after yield */
-    uint16_t resume_pc;
+    /* === Self-Modifying Code Tracking === */
     
-    /** Flag indicating we should yield back to main loop */
-    bool should_yield;
+    /** Pages whose recompiled code no longer matches memory */
+    uint32_t smc_dirty[CHIP8_SMC_NUM_PAGES / 32];
     
     /* === Platform Data === */
     
     /** Opaque pointer to platform-specific data (SDL window, etc.) */
     void* platform_data;
     
+    /** The user asked for a reset (debug overlay); the runtime resets after the frame */
+    bool reset_requested;
+    
     /* === Debug/Statistics === */
     
     /** Total instructions executed (for debugging) */
@@ -159,8 +222,39 @@ typedef struct Chip8Context {
     /** Current frame number */
     uint64_t frame_count;
     
+    /** Frames executed; drives the virtual clock (chip8_context_virtual_time_us) */
+    uint64_t virtual_frames;
+    
+    /** Most recently entered blocks, overwritten oldest first (CHIP8_TRACE_BLOCK) */
+    uint16_t block_trace[CHIP8_BLOCK_TRACE_SIZE];
+    
+    /** Blocks recorded so far; the newest is at (block_trace_count - 1) % CHIP8_BLOCK_TRACE_SIZE */
+    uint32_t block_trace_count;
+    
+    /** Breakpoints and watchpoints (NULL = none; see debugger.h) */
+    struct Chip8Debugger* debugger;
+    
 } Chip8Context;
 
+#ifdef __cplusplus
+#define CHIP8_STATIC_ASSERT(cond, msg) static_assert(cond, msg)
+#else
+#define CHIP8_STATIC_ASSERT(cond, msg) _Static_assert(cond, msg)
+#endif
+
+/* Keep the hot header within one cache line and the bulk arrays at fixed offsets */
+CHIP8_STATIC_ASSERT(offsetof(Chip8Context, V) == 0,
+                    "registers must start the context");
+CHIP8_STATIC_ASSERT(offsetof(Chip8Context, cycles_remaining) + sizeof(int) <= CHIP8_CACHE_LINE_SIZE,
+                    "cycle budget must share the registers' cache line");
+CHIP8_STATIC_ASSERT(offsetof(Chip8Context, watch_map) + sizeof(const uint8_t*) <= CHIP8_CACHE_LINE_SIZE,
+                    "hot header must fit in one cache line");
+CHIP8_STATIC_ASSERT(offsetof(Chip8Context, stack) <= CHIP8_CACHE_LINE_SIZE,
+                    "stack must directly follow the hot header");
+CHIP8_STATIC_ASSERT(offsetof(Chip8Context, memory) ==
+                    offsetof(Chip8Context, stack) + CHIP8_STACK_SIZE * sizeof(uint16_t),
+                    "memory must directly follow the stack");
+
 /* ============================================================================
  * Context Lifecycle Functions
  * ========================================================================== */
@@ -168,7 +262,8 @@ typedef struct Chip8Context {
 /**
  * @brief Create and initialize a new CHIP-8 context
  * 
- * Allocates memory and initializes all fields to their default state.
+ * Allocates memory aligned to CHIP8_CACHE_LINE_SIZE and initializes all
+ * fields to their default state.
  * The built-in font is loaded into memory at CHIP8_FONT_START.
  * 
  * @return Pointer to new context, or NULL on allocation failure
@@ -205,6 +300,32 @@ bool chip8_context_load_program(Chip8Context* ctx,
                                  const uint8_t* program_data, 
                                  size_t size);
 
+/**
+ * @brief Get the context's virtual time in microseconds
+ * 
+ * Advances by exactly one 60 Hz frame per frame the runtime executes,
+ * however long the host takes, so timing derived from it is deterministic.
+ * Not affected by chip8_context_reset.
+ * 
+ * @param ctx CHIP-8 context
+ * @return Emulated time since the context was created
+ */
+uint64_t chip8_context_virtual_time_us(const Chip8Context* ctx);
+
+/**
+ * @brief Copy the most recently entered blocks out of the trace ring
+ * 
+ * The ring is only written when the program was generated with
+ * --block-trace. It has a single writer and no lock: the count is read
+ * first and only entries it covers are copied.
+ * 
+ * @param ctx CHIP-8 context
+ * @param out Block start addresses, newest first
+ * @param max Capacity of out
+ * @return Number of addresses copied (at most CHIP8_BLOCK_TRACE_SIZE)
+ */
+int chip8_context_recent_blocks(const Chip8Context* ctx, uint16_t* out, int max);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,154 @@
+/**
+ * @file debugger.h
+ * @brief Breakpoints, watchpoints and block stepping
+ *
+ * Generated code and the interpreter call CHIP8_BREAKPOINT at every block
+ * entry, and the memory store helpers report writes through
+ * chip8_debugger_note_write(). When the program stops, chip8_debugger_break()
+ * runs a nested loop that keeps polling and rendering (so the debug overlay
+ * stays live) until the user continues or steps. Stopping in place rather
+ * than yielding to the main loop works the same in both generation modes,
+ * including inside subroutines whose C frames could not be resumed.
+ *
+ * CHIP8_DEBUGGER defaults to 1 unless NDEBUG is defined, so Release builds
+ * compile every hook to nothing. Define it to 0 or 1 to override.
+ */
+
+#ifndef CHIP8RT_DEBUGGER_H
+#define CHIP8RT_DEBUGGER_H
+
+#include "context.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CHIP8_DEBUGGER
+#ifdef NDEBUG
+#define CHIP8_DEBUGGER 0
+#else
+#define CHIP8_DEBUGGER 1
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define CHIP8_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+#define CHIP8_UNLIKELY(x) (x)
+#endif
+
+/**
+ * @brief Debugger state, attached to the running context
+ */
+typedef struct Chip8Debugger {
+    /** Nonzero for each address whose block stops the program when entered */
+    uint8_t breakpoints[CHIP8_MEMORY_SIZE];
+
+    /** Nonzero for each address that stops the program after a store to it */
+    uint8_t watchpoints[CHIP8_MEMORY_SIZE];
+    int num_breakpoints;
+    int num_watchpoints;
+
+    /** Stop at the next block entry (step, pause, watchpoint hit) */
+    bool stop;
+
+    /** Stopped in chip8_debugger_break() */
+    bool paused;
+
+    /** Block the program stopped at */
+    uint16_t break_pc;
+
+    /** A store to watch_addr caused the stop */
+    bool watch_hit;
+    uint16_t watch_addr;
+
+    /** Times the program stopped */
+    uint64_t breaks;
+} Chip8Debugger;
+
+/**
+ * @brief Get the debugger the runtime attaches to its context
+ */
+Chip8Debugger* chip8_debugger_get(void);
+
+/**
+ * @brief Set or clear a breakpoint on the block starting at addr
+ */
+void chip8_debugger_set_breakpoint(Chip8Debugger* dbg, uint16_t addr, bool enabled);
+
+/**
+ * @brief Set or clear a watchpoint on the byte at addr
+ */
+void chip8_debugger_set_watchpoint(Chip8Debugger* dbg, uint16_t addr, bool enabled);
+
+/**
+ * @brief Stop at the next block entry
+ */
+void chip8_debugger_pause(Chip8Debugger* dbg);
+
+/**
+ * @brief Leave a stop
+ *
+ * @param dbg Debugger
+ * @param step Stop again at the next block entry
+ */
+void chip8_debugger_resume(Chip8Debugger* dbg, bool step);
+
+/**
+ * @brief Stop at the block starting at addr until resumed
+ *
+ * Polls and renders through the registered platform at 60 Hz meanwhile.
+ * Returns early if the program quits, or when the overlay requests a reset
+ * (ctx->reset_requested), ending the frame at once.
+ *
+ * @param ctx CHIP-8 context
+ * @param addr Block start address
+ */
+void chip8_debugger_break(Chip8Context* ctx, uint16_t addr);
+
+/**
+ * @brief Slow path of chip8_debugger_note_write() - some watchpoint is set
+ */
+void chip8_debugger_check_write(Chip8Context* ctx, uint16_t addr, uint16_t len);
+
+#if CHIP8_DEBUGGER
+
+/**
+ * @brief Stop here if a breakpoint is set on addr or a stop is pending
+ *
+ * Emitted at every block entry; expands to nothing without CHIP8_DEBUGGER.
+ */
+#define CHIP8_BREAKPOINT(ctx, addr) do { \
+    Chip8Debugger* _dbg = (ctx)->debugger; \
+    if (CHIP8_UNLIKELY(_dbg && (_dbg->stop || _dbg->breakpoints[(addr) & 0x0FFF]))) { \
+        chip8_debugger_break((ctx), (addr)); \
+    } \
+} while(0)
+
+/**
+ * @brief Note a store for watchpoints (called by the store helpers)
+ */
+static inline void chip8_debugger_note_write(Chip8Context* ctx, uint16_t addr, uint16_t len) {
+    Chip8Debugger* dbg = ctx->debugger;
+    if (CHIP8_UNLIKELY(dbg && dbg->num_watchpoints > 0)) {
+        chip8_debugger_check_write(ctx, addr, len);
+    }
+}
+
+#else
+
+#define CHIP8_BREAKPOINT(ctx, addr) ((void)0)
+
+static inline void chip8_debugger_note_write(Chip8Context* ctx, uint16_t addr, uint16_t len) {
+    (void)ctx;
+    (void)addr;
+    (void)len;
+}
+
+#endif /* CHIP8_DEBUGGER */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CHIP8RT_DEBUGGER_H */
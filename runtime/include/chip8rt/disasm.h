@@ -0,0 +1,72 @@
+/**
+ * @file disasm.h
+ * @brief CHIP-8 disassembler for the runtime's debug views
+ *
+ * Table-driven: each opcode is matched against a list of mask/pattern
+ * pairs and formatted from its operand layout. The syntax follows the
+ * recompiler's --disasm output (e.g., "LD   VA, 0x5").
+ *
+ * Views that redraw every frame go through Chip8DisasmCache, which keeps
+ * the decoded line per address keyed by the opcode it was decoded from.
+ * A store that changes the opcode invalidates the line the next time it
+ * is read, so self-modifying code is always shown as it is now.
+ */
+
+#ifndef CHIP8RT_DISASM_H
+#define CHIP8RT_DISASM_H
+
+#include "context.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Longest disassembled line, including the terminator */
+#define CHIP8_DISASM_MAX_LEN    24
+
+/**
+ * @brief Decoded lines per address
+ */
+typedef struct Chip8DisasmCache {
+    /** Opcode each line was decoded from */
+    uint16_t opcode[CHIP8_MEMORY_SIZE];
+
+    /** Line has been decoded */
+    bool valid[CHIP8_MEMORY_SIZE];
+
+    char text[CHIP8_MEMORY_SIZE][CHIP8_DISASM_MAX_LEN];
+} Chip8DisasmCache;
+
+/**
+ * @brief Disassemble one opcode
+ *
+ * @param opcode Big-endian instruction word
+ * @param buf Output buffer
+ * @param size Size of buf (CHIP8_DISASM_MAX_LEN fits any instruction)
+ * @return Length of the text, as snprintf
+ */
+int chip8_disassemble(uint16_t opcode, char* buf, size_t size);
+
+/**
+ * @brief Drop every cached line
+ */
+void chip8_disasm_cache_clear(Chip8DisasmCache* cache);
+
+/**
+ * @brief Get the disassembly of the instruction at addr
+ *
+ * Decodes only when the line is missing or memory now holds a
+ * different opcode there.
+ *
+ * @param cache Line cache
+ * @param memory Memory to read (CHIP8_MEMORY_SIZE bytes)
+ * @param addr Instruction address (0x000 - 0xFFE)
+ * @return Disassembly, valid until the line is next decoded
+ */
+const char* chip8_disasm_cached(Chip8DisasmCache* cache, const uint8_t* memory, uint16_t addr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CHIP8RT_DISASM_H */
@@ -0,0 +1,128 @@
+/**
+ * @file idle.h
+ * @brief Event-driven host idling for menus and waits
+ *
+ * Screens that only change on input (the pause menu, the ROM launcher, an
+ * FX0A key wait) should not redraw and sleep at 60 Hz forever. The idle
+ * scheduler keeps frame pacing while something is animating or a redraw is
+ * pending, and otherwise blocks on Chip8Platform::wait_event until input
+ * arrives or a timeout passes. Each wakeup records why it happened so the
+ * behavior can be checked from the debug log.
+ *
+ * Typical loop:
+ *   poll input; on a change call chip8_idle_invalidate()
+ *   if (chip8_idle_needs_draw(&idle, now)) draw
+ *   chip8_idle_wait(&idle, ctx, frame_start, frame_period_us)
+ */
+
+#ifndef CHIP8RT_IDLE_H
+#define CHIP8RT_IDLE_H
+
+#include "context.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Longest a blocked wait lasts before the loop runs again */
+#define CHIP8_IDLE_TIMEOUT_MS       250
+
+/** Frames keep drawing this long after input (lets ImGui settle hover/active states) */
+#define CHIP8_IDLE_SETTLE_US        250000
+
+/**
+ * @brief Why chip8_idle_wait() returned
+ */
+typedef enum Chip8WakeReason {
+    CHIP8_WAKE_FRAME,       /* Drawing: slept out the rest of the frame */
+    CHIP8_WAKE_INPUT,       /* Blocked until an input event arrived */
+    CHIP8_WAKE_TIMEOUT,     /* Blocked for the whole timeout */
+    CHIP8_WAKE_REASON_COUNT
+} Chip8WakeReason;
+
+/**
+ * @brief Idle scheduler state
+ */
+typedef struct Chip8IdleScheduler {
+    /** Draw on the next frame */
+    bool redraw;
+
+    /** Draw every frame until this time (microseconds, platform clock) */
+    uint64_t active_until_us;
+
+    /** Longest blocked wait */
+    uint32_t timeout_ms;
+
+    /** Reason for the most recent wakeup, and a count per reason */
+    Chip8WakeReason last_wake;
+    uint64_t wakes[CHIP8_WAKE_REASON_COUNT];
+} Chip8IdleScheduler;
+
+/**
+ * @brief Initialize a scheduler with one redraw pending
+ *
+ * @param idle Scheduler
+ * @param timeout_ms Longest blocked wait (CHIP8_IDLE_TIMEOUT_MS)
+ */
+void chip8_idle_init(Chip8IdleScheduler* idle, uint32_t timeout_ms);
+
+/**
+ * @brief Request a single redraw (state changed)
+ */
+void chip8_idle_invalidate(Chip8IdleScheduler* idle);
+
+/**
+ * @brief Keep drawing every frame for a while (an animation is running)
+ *
+ * @param idle Scheduler
+ * @param now_us Current platform time
+ * @param duration_us How long to keep drawing
+ */
+void chip8_idle_animate(Chip8IdleScheduler* idle, uint64_t now_us, uint64_t duration_us);
+
+/**
+ * @brief Check whether this frame should be drawn
+ *
+ * Consumes a pending redraw request.
+ *
+ * @param idle Scheduler
+ * @param now_us Current platform time
+ * @return true if a redraw is pending or an animation is running
+ */
+bool chip8_idle_needs_draw(Chip8IdleScheduler* idle, uint64_t now_us);
+
+/**
+ * @brief Wait for the next iteration of the loop
+ *
+ * Sleeps out the rest of the frame while drawing is needed. Otherwise
+ * blocks on the platform's wait_event (falling back to frame pacing when
+ * the platform has none). Input wakeups keep drawing for
+ * CHIP8_IDLE_SETTLE_US so the result of the input is shown.
+ *
+ * @param idle Scheduler
+ * @param ctx Context passed to the platform
+ * @param frame_start_us Platform time the iteration started
+ * @param frame_period_us Frame length while drawing
+ * @return Why the wait ended (also stored in last_wake)
+ */
+Chip8WakeReason chip8_idle_wait(Chip8IdleScheduler* idle, Chip8Context* ctx,
+                                uint64_t frame_start_us, uint64_t frame_period_us);
+
+/**
+ * @brief Log the wakeup counts with chip8_debug
+ *
+ * @param idle Scheduler
+ * @param name Loop the scheduler belongs to (e.g., "menu")
+ */
+void chip8_idle_report(const Chip8IdleScheduler* idle, const char* name);
+
+/**
+ * @brief Get the name of a wakeup reason (e.g., "input")
+ */
+const char* chip8_wake_reason_name(Chip8WakeReason reason);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CHIP8RT_IDLE_H */
@@ -11,6 +11,9 @@
 #define CHIP8RT_INSTRUCTIONS_H
 
 #include "context.h"
+#include "debugger.h"
+#include "interpreter.h"
+#include <string.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -159,7 +162,7 @@ static inline void chip8_write_byte(Chip8Context* ctx, uint16_t addr, uint8_t va
  */
 static inline uint16_t chip8_read_word(Chip8Context* ctx, uint16_t addr) {
     uint16_t masked = addr & 0x0FFF;
-    return ((uint16_t)ctx->memory[masked] << 8) | ctx->memory[masked + 1];
+    return ((uint16_t)ctx->memory[masked] << 8) | ctx->memory[(masked + 1) & 0x0FFF];
 }
 
 /* ============================================================================
@@ -199,8 +202,9 @@ bool chip8_key_pressed(Chip8Context* ctx, uint8_t key);
 /**
  * @brief LD Vx, K - Wait for key press (FX0A)
  * 
- * Blocks execution until a key is pressed and released.
- * Returns the key value (0x0-0xF).
+ * Marks the context as waiting; the runtime stores the next released key
+ * (0x0-0xF) in the register. Callers must stop executing and yield
+ * (CHIP8_WAIT_KEY) so nothing after the wait runs before the key arrives.
  * 
  * @param ctx CHIP-8 context
  * @param reg Register index to store key value
@@ -243,17 +247,169 @@ void chip8_load_registers(Chip8Context* ctx, uint8_t x, bool increment_i);
 /**
  * @brief RND Vx, NN - Generate random number (CXNN)
  * 
+ * Advances the context's generator (ctx->rng_state).
+ * 
+ * @param ctx CHIP-8 context
+ * @return Random byte (0-255)
+ */
+uint8_t chip8_random_next(Chip8Context* ctx);
+
+/**
+ * @brief Seed a context's random number generator
+ * 
+ * @param ctx CHIP-8 context
+ * @param seed Seed value (0 selects CHIP8_RNG_DEFAULT_STATE)
+ */
+void chip8_random_seed_context(Chip8Context* ctx, uint32_t seed);
+
+/**
+ * @brief Generate a random byte from the running context's generator
+ * 
+ * Kept for compatibility; uses chip8_get_context(), or a private
+ * generator when no program is running. Prefer chip8_random_next().
+ * 
  * @return Random byte (0-255)
  */
 uint8_t chip8_random_byte(void);
 
 /**
- * @brief Seed the random number generator
+ * @brief Seed the running context's random number generator
+ * 
+ * Kept for compatibility; see chip8_random_byte().
  * 
  * @param seed Seed value (typically time-based)
  */
 void chip8_random_seed(uint32_t seed);
 
+/**
+ * @brief Get the running context's random number generator state
+ * 
+ * Passing the result to chip8_random_seed() replays the same sequence.
+ * 
+ * @return Generator state
+ */
+uint32_t chip8_random_get_state(void);
+
+/* ============================================================================
+ * Inline Fast Paths
+ * ========================================================================== */
+
+/*
+ * Static inline versions of the helpers above, so generated code does not
+ * pay for a call (and the register spills around it) in every block that
+ * tests a key, stores BCD or moves registers to and from memory.
+ * 
+ * With CHIP8_INLINE_HELPERS set to 1 (the default) the public names expand
+ * to these versions. Build with -DCHIP8_INLINE_HELPERS=0 to call the
+ * out-of-line functions instead; they are always exported.
+ */
+#ifndef CHIP8_INLINE_HELPERS
+#define CHIP8_INLINE_HELPERS 1
+#endif
+
+static inline bool chip8_key_pressed_inline(Chip8Context* ctx, uint8_t key) {
+    /* Mask to lower nibble as per original CHIP-8 behavior (CTR errata) */
+    return ctx->keys[key & 0xF];
+}
+
+/*
+ * FX33/FX55/FX65 address memory at I + i. I can point anywhere in the
+ * 16-bit register, so the common case (the whole range inside memory) is a
+ * single memcpy - a fixed-size move once x is a constant in generated code -
+ * and anything else wraps each address to 12 bits rather than running off
+ * the end of memory into the rest of the context.
+ */
+static inline bool chip8_range_in_memory(uint16_t addr, unsigned len) {
+    return (unsigned)addr + len <= CHIP8_MEMORY_SIZE;
+}
+
+/* Report a store that may wrap past the end of memory */
+static inline void chip8_note_store_range(Chip8Context* ctx, uint16_t addr, unsigned len) {
+    uint16_t start = addr & 0x0FFF;
+    unsigned first = CHIP8_MEMORY_SIZE - start;
+    chip8_debugger_note_write(ctx, start, (uint16_t)len);
+    if (len <= first) {
+        chip8_smc_note_write(ctx, start, (uint16_t)len);
+    } else {
+        chip8_smc_note_write(ctx, start, (uint16_t)first);
+        chip8_smc_note_write(ctx, 0, (uint16_t)(len - first));
+    }
+}
+
+static inline void chip8_store_bcd_inline(Chip8Context* ctx, uint8_t x) {
+    uint8_t value = ctx->V[x];
+    uint8_t digits[3] = {
+        (uint8_t)(value / 100),         /* Hundreds */
+        (uint8_t)((value / 10) % 10),   /* Tens */
+        (uint8_t)(value % 10)           /* Ones */
+    };
+    
+    if (chip8_range_in_memory(ctx->I, 3)) {
+        memcpy(&ctx->memory[ctx->I], digits, 3);
+    } else {
+        for (unsigned i = 0; i < 3; ++i) {
+            ctx->memory[(ctx->I + i) & 0x0FFF] = digits[i];
+        }
+    }
+    
+    chip8_note_store_range(ctx, ctx->I, 3);
+}
+
+static inline void chip8_store_registers_inline(Chip8Context* ctx, uint8_t x, bool increment_i) {
+    unsigned count = (unsigned)(x & 0xF) + 1;
+    
+    if (chip8_range_in_memory(ctx->I, count)) {
+        memcpy(&ctx->memory[ctx->I], ctx->V, count);
+    } else {
+        for (unsigned i = 0; i < count; ++i) {
+            ctx->memory[(ctx->I + i) & 0x0FFF] = ctx->V[i];
+        }
+    }
+    chip8_note_store_range(ctx, ctx->I, count);
+    
+    if (increment_i) {
+        ctx->I += count;
+    }
+}
+
+static inline void chip8_load_registers_inline(Chip8Context* ctx, uint8_t x, bool increment_i) {
+    unsigned count = (unsigned)(x & 0xF) + 1;
+    
+    if (chip8_range_in_memory(ctx->I, count)) {
+        memcpy(ctx->V, &ctx->memory[ctx->I], count);
+    } else {
+        for (unsigned i = 0; i < count; ++i) {
+            ctx->V[i] = ctx->memory[(ctx->I + i) & 0x0FFF];
+        }
+    }
+    
+    if (increment_i) {
+        ctx->I += count;
+    }
+}
+
+/* Advance an xorshift32 generator and return its low byte */
+static inline uint8_t chip8_random_step(uint32_t* state) {
+    uint32_t s = *state;
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    *state = s;
+    return (uint8_t)(s & 0xFF);
+}
+
+static inline uint8_t chip8_random_next_inline(Chip8Context* ctx) {
+    return chip8_random_step(&ctx->rng_state);
+}
+
+#if CHIP8_INLINE_HELPERS
+#define chip8_key_pressed(ctx, key)             chip8_key_pressed_inline((ctx), (key))
+#define chip8_store_bcd(ctx, x)                 chip8_store_bcd_inline((ctx), (x))
+#define chip8_store_registers(ctx, x, inc_i)    chip8_store_registers_inline((ctx), (x), (inc_i))
+#define chip8_load_registers(ctx, x, inc_i)     chip8_load_registers_inline((ctx), (x), (inc_i))
+#define chip8_random_next(ctx)                  chip8_random_next_inline((ctx))
+#endif
+
 /* ============================================================================
  * Timer Functions
  * ========================================================================== */
@@ -267,6 +423,32 @@ void chip8_random_seed(uint32_t seed);
  */
 void chip8_tick_timers(Chip8Context* ctx);
 
+/**
+ * @brief Set the sound timer (FX18)
+ * 
+ * Records a sound event when the tone starts or stops, so the audio
+ * callback can switch it at this point in the frame.
+ * 
+ * @param ctx CHIP-8 context
+ * @param value New sound timer value
+ */
+void chip8_set_sound_timer(Chip8Context* ctx, uint8_t value);
+
+/**
+ * @brief Load the XO-CHIP audio pattern from memory at I (F002)
+ * 
+ * @param ctx CHIP-8 context
+ */
+void chip8_load_audio_pattern(Chip8Context* ctx);
+
+/**
+ * @brief Set the XO-CHIP pitch register from Vx (FX3A)
+ * 
+ * @param ctx CHIP-8 context
+ * @param x Register index
+ */
+void chip8_set_audio_pitch(Chip8Context* ctx, uint8_t x);
+
 /**
  * @brief Check if sound should be playing
  * 
@@ -302,6 +484,48 @@ static inline bool chip8_sound_active(Chip8Context* ctx) {
     } \
 } while(0)
 
+/**
+ * @brief End the frame from an idle loop
+ * 
+ * Replaces the backward jump closing a loop that only waits on the delay
+ * timer or the keys. Neither changes before the next frame, so the rest of
+ * the cycle budget would repeat the same iteration: spend it at once (as
+ * the loop would have, one cycle per jump) and resume at the loop head.
+ */
+#define CHIP8_IDLE_YIELD(ctx, resume_addr) do { \
+    (ctx)->cycles_remaining = (ctx)->cycles_remaining > 0 ? 0 : (ctx)->cycles_remaining - 1; \
+    (ctx)->resume_pc = (resume_addr); \
+    (ctx)->should_yield = true; \
+    (ctx)->idle = true; \
+    return; \
+} while(0)
+
+/**
+ * @brief LD Vx, K - wait for a key and end the frame (FX0A)
+ * 
+ * The runtime stops calling the entry point until a key is released, stores
+ * it in Vx and resumes at resume_addr, the instruction after the wait.
+ */
+#define CHIP8_WAIT_KEY(ctx, reg, resume_addr) do { \
+    chip8_wait_key((ctx), (reg)); \
+    (ctx)->resume_pc = (resume_addr); \
+    (ctx)->should_yield = true; \
+    return; \
+} while(0)
+
+/**
+ * @brief Record entry to the block at addr (generated with --block-trace)
+ * 
+ * Sets ctx->PC so the debug overlay follows execution, and appends addr to
+ * the context's block trace ring. The entry is stored before the count is
+ * bumped, so a reader that takes the count first never sees a stale slot.
+ */
+#define CHIP8_TRACE_BLOCK(ctx, addr) do { \
+    (ctx)->PC = (addr); \
+    (ctx)->block_trace[(ctx)->block_trace_count & (CHIP8_BLOCK_TRACE_SIZE - 1)] = (addr); \
+    (ctx)->block_trace_count++; \
+} while(0)
+
 /**
  * @brief Check if we should resume from a previous yield
  * 
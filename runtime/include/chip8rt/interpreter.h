@@ -0,0 +1,232 @@
+/**
+ * @file interpreter.h
+ * @brief Fallback interpreter and self-modifying code detection
+ *
+ * Recompiled code is a snapshot of the ROM taken at build time. Programs
+ * that write into their own code region (FX55, FX33) would otherwise keep
+ * running the stale translation. The runtime tracks stores against a
+ * bitmap of recompiled code addresses; when one hits, execution moves to
+ * a built-in interpreter that reads instructions straight from memory,
+ * and returns to recompiled code once it reaches an unmodified block.
+ *
+ * The same interpreter runs code the analyzer never saw: computed jump
+ * and return targets without a recompiled label are handed to it rather
+ * than treated as fatal.
+ */
+
+#ifndef CHIP8RT_INTERPRETER_H
+#define CHIP8RT_INTERPRETER_H
+
+#include "context.h"
+#include "platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * Code Map Registration
+ * ========================================================================== */
+
+/** Quirk flags baked into recompiled code (the interpreter must match them) */
+#define CHIP8_QUIRK_VF_RESET          (1u << 0)
+#define CHIP8_QUIRK_SHIFT_VY          (1u << 1)
+#define CHIP8_QUIRK_LOAD_STORE_INC_I  (1u << 2)
+
+/**
+ * @brief Description of the recompiled code, emitted by the generator
+ */
+typedef struct Chip8CodeInfo {
+    /** Bit per address that holds recompiled code (CHIP8_CODE_MAP_SIZE bytes) */
+    const uint8_t* code_map;
+
+    /** Bit per address where recompiled code can be re-entered via resume_pc */
+    const uint8_t* resume_map;
+
+    /** CHIP8_QUIRK_* flags the code was generated with */
+    uint32_t quirks;
+
+    /** Code records block entries (--block-trace); the interpreter does too */
+    bool block_trace;
+} Chip8CodeInfo;
+
+/**
+ * @brief Register the code description of the loaded program
+ *
+ * Called from the generated <prefix>_register_functions(). Pass NULL
+ * to disable tracking.
+ *
+ * @param info Code description (must outlive the run)
+ */
+void chip8_register_code_info(const Chip8CodeInfo* info);
+
+/**
+ * @brief Get the registered code description
+ *
+ * @return Registered description, or NULL
+ */
+const Chip8CodeInfo* chip8_get_code_info(void);
+
+/* ============================================================================
+ * Self-Modifying Code Tracking
+ * ========================================================================== */
+
+/**
+ * @brief Attach the registered code map to a context
+ *
+ * Snapshots the current memory as the pristine program image, flushes
+ * the translation cache and clears all dirty state. Call after the
+ * program has been loaded.
+ *
+ * @param ctx CHIP-8 context
+ */
+void chip8_smc_reset(Chip8Context* ctx);
+
+/**
+ * @brief Slow path of chip8_smc_note_write() - a store touched code
+ *
+ * Drops cached translations of the written bytes, re-evaluates the
+ * affected pages against the pristine image and sets ctx->smc_pending
+ * if any recompiled code now differs.
+ *
+ * @param ctx CHIP-8 context
+ * @param addr First address written
+ * @param len Number of bytes written
+ */
+void chip8_smc_record_write(Chip8Context* ctx, uint16_t addr, uint16_t len);
+
+/**
+ * @brief Check whether the recompiled block starting at addr is stale
+ *
+ * @param ctx CHIP-8 context
+ * @param addr Block start address
+ * @return true if any page covered by the block has been modified
+ */
+bool chip8_smc_block_dirty(const Chip8Context* ctx, uint16_t addr);
+
+/**
+ * @brief Continue with ctx after running code on another context
+ *
+ * The translation cache is shared, so blocks decoded while running a copy
+ * of ctx (run-ahead) may come from bytes ctx's memory does not have. Drops
+ * the translations of every byte where the two memories differ.
+ *
+ * @param ctx Context that runs next
+ * @param other Context that ran since ctx last did
+ */
+void chip8_smc_sync(const Chip8Context* ctx, const Chip8Context* other);
+
+/**
+ * @brief Test a bitmap for any set bit in [addr, addr + len)
+ *
+ * Reads a single 32-bit window, so len must be at most 24.
+ */
+static inline bool chip8_code_map_test(const uint8_t* map, uint16_t addr, uint16_t len) {
+    uint16_t byte = (addr & 0x0FFF) >> 3;
+    uint32_t window = (uint32_t)map[byte] |
+                      ((uint32_t)map[byte + 1] << 8) |
+                      ((uint32_t)map[byte + 2] << 16) |
+                      ((uint32_t)map[byte + 3] << 24);
+    uint32_t mask = ((1u << len) - 1) << (addr & 7);
+    return (window & mask) != 0;
+}
+
+/**
+ * @brief Note a store to memory (called by FX33/FX55 helpers)
+ *
+ * The common case costs one bitmap test.
+ *
+ * @param ctx CHIP-8 context
+ * @param addr First address written
+ * @param len Number of bytes written (1-16)
+ */
+static inline void chip8_smc_note_write(Chip8Context* ctx, uint16_t addr, uint16_t len) {
+    if (ctx->watch_map && chip8_code_map_test(ctx->watch_map, addr, len)) {
+        chip8_smc_record_write(ctx, addr, len);
+    }
+}
+
+/* ============================================================================
+ * Fallback Interpreter
+ * ========================================================================== */
+
+/**
+ * @brief Why chip8_interp_run() returned
+ */
+typedef enum Chip8InterpExit {
+    /** Cycle budget exhausted or FX0A wait; resume_pc holds the interpreter PC */
+    CHIP8_INTERP_EXIT_YIELD,
+
+    /** Reached unmodified recompiled code; resume_pc/should_yield are set for dispatch */
+    CHIP8_INTERP_EXIT_RESUME,
+
+    /** Executed RET with an empty stack (or, nested, the stack it started with) */
+    CHIP8_INTERP_EXIT_RETURN
+} Chip8InterpExit;
+
+/**
+ * @brief Interpret CHIP-8 code from memory
+ *
+ * Charges cycles exactly like generated code (one per DRW and per taken
+ * backward jump, yielding only at backward jumps), so a program behaves
+ * the same whichever engine runs it. Calls and jumps to addresses with a
+ * registered function run that function natively; if it yields, this run
+ * yields too and the interpreter finishes the function next frame. Blocks
+ * are decoded on first execution and cached until a store overwrites them.
+ *
+ * @param ctx CHIP-8 context
+ * @param pc Address to start at
+ * @return Exit reason
+ */
+Chip8InterpExit chip8_interp_run(Chip8Context* ctx, uint16_t pc);
+
+/**
+ * @brief Run one frame's worth of code
+ *
+ * Continues the interpreter if it owns execution, diverts stale resume
+ * points to it, and otherwise calls the recompiled entry point.
+ *
+ * @param ctx CHIP-8 context
+ * @param entry Recompiled entry point
+ */
+void chip8_execute(Chip8Context* ctx, Chip8EntryPoint entry);
+
+/* ============================================================================
+ * Generated Code Hooks
+ * ========================================================================== */
+
+/**
+ * @brief Continue at pc in the interpreter (single-function mode)
+ *
+ * Jumps back to the function's resume dispatcher once the interpreter
+ * reaches recompiled code, and returns to the main loop otherwise.
+ */
+#define CHIP8_INTERP_HANDOFF(ctx, pc, dispatch_label) do { \
+    if (chip8_interp_run((ctx), (pc)) != CHIP8_INTERP_EXIT_RESUME) return; \
+    goto dispatch_label; \
+} while(0)
+
+/**
+ * @brief Hand off to the interpreter after a store hit code (single-function mode)
+ */
+#define CHIP8_SMC_GUARD(ctx, next_pc, dispatch_label) do { \
+    if ((ctx)->smc_pending) CHIP8_INTERP_HANDOFF(ctx, next_pc, dispatch_label); \
+} while(0)
+
+/**
+ * @brief Hand off to the interpreter after a store hit code (per-function mode)
+ *
+ * The interpreter finishes the current function and returns at its RET.
+ */
+#define CHIP8_SMC_GUARD_FUNC(ctx, next_pc) do { \
+    if ((ctx)->smc_pending) { \
+        chip8_interp_run((ctx), (next_pc)); \
+        return; \
+    } \
+} while(0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CHIP8RT_INTERPRETER_H */
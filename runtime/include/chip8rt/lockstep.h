@@ -0,0 +1,88 @@
+/**
+ * @file lockstep.h
+ * @brief Differential execution against a reference interpreter
+ *
+ * Lockstep mode runs a straightforward reference interpreter on a second
+ * context alongside the recompiled program. Both engines get the same
+ * inputs, timer values and random numbers each frame; at every yield the
+ * registers, I, stack, timers, memory and display are compared and the
+ * first divergence is reported with its frame number and yield address.
+ * The stack is only compared in single-function builds; per-function
+ * builds call subroutines as C functions and never push it.
+ */
+
+#ifndef CHIP8RT_LOCKSTEP_H
+#define CHIP8RT_LOCKSTEP_H
+
+#include "context.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Opaque lockstep state (reference context plus bookkeeping) */
+typedef struct Chip8Lockstep Chip8Lockstep;
+
+/**
+ * @brief Create a lockstep checker
+ *
+ * The reference context starts as a copy of ctx, so call this after the
+ * program has been loaded.
+ *
+ * @param ctx Context the recompiled code runs on
+ * @return New checker, or NULL on allocation failure
+ */
+Chip8Lockstep* chip8_lockstep_create(const Chip8Context* ctx);
+
+/**
+ * @brief Destroy a lockstep checker
+ *
+ * @param ls Checker to destroy (safe to pass NULL)
+ */
+void chip8_lockstep_destroy(Chip8Lockstep* ls);
+
+/**
+ * @brief Restart the reference from a freshly reset context
+ *
+ * @param ls Lockstep checker
+ * @param ctx Context the recompiled code runs on
+ */
+void chip8_lockstep_reset(Chip8Lockstep* ls, const Chip8Context* ctx);
+
+/**
+ * @brief Prepare a frame
+ *
+ * Copies this frame's input and timer state into the reference context
+ * and copies the random number generator state. Call after polling
+ * input and before resolving FX0A waits.
+ *
+ * @param ls Lockstep checker
+ * @param ctx Context the recompiled code runs on
+ */
+void chip8_lockstep_begin_frame(Chip8Lockstep* ls, const Chip8Context* ctx);
+
+/**
+ * @brief Run the reference for one frame and compare
+ *
+ * Call after the recompiled code has run its frame.
+ *
+ * @param ls Lockstep checker
+ * @param ctx Context the recompiled code ran on
+ * @param cycles Cycle budget the recompiled code was given
+ * @return false if the engines have diverged (report printed to stderr)
+ */
+bool chip8_lockstep_end_frame(Chip8Lockstep* ls, const Chip8Context* ctx, int cycles);
+
+/**
+ * @brief Check whether a divergence has been reported
+ *
+ * @param ls Lockstep checker
+ * @return true after the first divergence
+ */
+bool chip8_lockstep_diverged(const Chip8Lockstep* ls);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CHIP8RT_LOCKSTEP_H */
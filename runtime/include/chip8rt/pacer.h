@@ -0,0 +1,124 @@
+/**
+ * @file pacer.h
+ * @brief Fixed-timestep frame pacing with precise sleeps
+ *
+ * Each emulated frame (one frame of cycles and one 60 Hz timer tick) has an
+ * absolute deadline, start + n * period, so a late frame does not shift the
+ * ones after it: the runtime catches up by running frames back to back
+ * (without rendering) until it is on schedule again. Only when it falls
+ * more than CHIP8_PACER_MAX_CATCHUP frames behind, after a stall or a
+ * pause, is the schedule restarted from the current time.
+ *
+ * Waiting for a deadline sleeps on the host clock (clock_nanosleep with
+ * an absolute deadline where available) until a short spin tail before it,
+ * then spins. The tail is calibrated from how late the sleeps actually
+ * wake, so the spin stays short on an idle machine.
+ */
+
+#ifndef CHIP8RT_PACER_H
+#define CHIP8RT_PACER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Frames the pacer runs back to back before restarting the schedule */
+#define CHIP8_PACER_MAX_CATCHUP     4
+
+/** Spin tail before the first calibration, and its bounds (nanoseconds) */
+#define CHIP8_PACER_SPIN_DEFAULT_NS 1000000
+#define CHIP8_PACER_SPIN_MIN_NS     50000
+#define CHIP8_PACER_SPIN_MAX_NS     2000000
+
+/**
+ * @brief Achieved timing, for diagnostics
+ */
+typedef struct Chip8PacerStats {
+    /** Deadlines waited for */
+    uint64_t frames;
+
+    /** Wake-up lateness past each deadline (nanoseconds) */
+    double jitter_sum_ns;
+    double jitter_sum_sq_ns;
+    uint64_t jitter_max_ns;
+
+    /** Frames that started after their deadline and ran without waiting */
+    uint64_t late_frames;
+
+    /** Times the schedule was restarted (stalls, pauses) */
+    uint64_t resyncs;
+} Chip8PacerStats;
+
+/**
+ * @brief Pacer state
+ */
+typedef struct Chip8Pacer {
+    /** Time of frame 0 and the frame whose deadline is next */
+    uint64_t start_ns;
+    uint64_t frame;
+
+    /** Frames per second */
+    uint32_t rate_hz;
+
+    /** Calibrated spin tail and the sleep overshoot it is derived from */
+    uint64_t spin_ns;
+    uint64_t oversleep_ns;
+
+    Chip8PacerStats stats;
+} Chip8Pacer;
+
+/**
+ * @brief Current host monotonic time in nanoseconds
+ */
+uint64_t chip8_pacer_now_ns(void);
+
+/**
+ * @brief Initialize a pacer whose first frame is due now
+ *
+ * @param pacer Pacer
+ * @param rate_hz Frames per second (CHIP8_TIMER_FREQ_HZ)
+ */
+void chip8_pacer_init(Chip8Pacer* pacer, uint32_t rate_hz);
+
+/**
+ * @brief Restart the schedule from the current time
+ *
+ * Call after the loop has not been running frames (pause menu, key wait),
+ * so the time spent there is not caught up.
+ */
+void chip8_pacer_resync(Chip8Pacer* pacer);
+
+/**
+ * @brief Check whether the current frame is already past its deadline
+ *
+ * A frame that is behind should skip rendering to catch up.
+ *
+ * @param pacer Pacer
+ * @return true if the next deadline has passed
+ */
+bool chip8_pacer_behind(const Chip8Pacer* pacer);
+
+/**
+ * @brief Finish a frame and wait for the next deadline
+ *
+ * Returns at once if the deadline has passed (the next frame catches up),
+ * and restarts the schedule if more than CHIP8_PACER_MAX_CATCHUP frames
+ * are due.
+ *
+ * @param pacer Pacer
+ */
+void chip8_pacer_wait(Chip8Pacer* pacer);
+
+/**
+ * @brief Log the jitter statistics with chip8_debug
+ */
+void chip8_pacer_report(const Chip8Pacer* pacer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CHIP8RT_PACER_H */
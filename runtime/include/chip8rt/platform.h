@@ -86,6 +86,18 @@ typedef struct Chip8Platform {
      */
     void (*beep_stop)(Chip8Context* ctx);
     
+    /**
+     * @brief Render sound from timestamped events (optional, may be NULL)
+     * 
+     * Called once after init with the ring the CPU records sound events
+     * into (see audio.h). A platform that implements it plays the ring from
+     * its audio callback and can ignore beep_start/beep_stop.
+     * 
+     * @param ctx CHIP-8 context
+     * @param ring Event ring, valid until shutdown
+     */
+    void (*audio_attach)(Chip8Context* ctx, struct Chip8AudioRing* ring);
+    
     /* === Input === */
     
     /**
@@ -146,7 +158,10 @@ typedef struct Chip8Platform {
     /**
      * @brief Get current time in microseconds
      * 
-     * Used for frame timing and pacing.
+     * Used for frame timing and pacing. Platforms that are not realtime
+     * return the running context's virtual clock
+     * (chip8_context_virtual_time_us), so timing does not depend on how
+     * often or how fast the loop calls this.
      * 
      * @return Current time in microseconds (monotonic)
      */
@@ -159,6 +174,27 @@ typedef struct Chip8Platform {
      */
     void (*sleep_us)(uint64_t microseconds);
     
+    /**
+     * @brief Pace frames in real time with the frame pacer (see pacer.h)
+     * 
+     * Platforms that run as fast as possible (headless) leave this false,
+     * run on virtual time and keep the sleep_us-based pacing.
+     */
+    bool realtime;
+    
+    /**
+     * @brief Block until an input event arrives (optional, may be NULL)
+     * 
+     * Used instead of frame pacing while nothing can change without input,
+     * such as an FX0A key wait with both timers stopped or an idle menu
+     * (see idle.h). Must leave the event queued for the next poll call.
+     * 
+     * @param ctx CHIP-8 context
+     * @param timeout_ms Longest time to block
+     * @return true if an event is pending, false on timeout
+     */
+    bool (*wait_event)(Chip8Context* ctx, uint32_t timeout_ms);
+    
 } Chip8Platform;
 
 /* ============================================================================
@@ -238,6 +274,12 @@ typedef struct Chip8RunConfig {
     /** Maximum frames to run (0 = unlimited, for headless testing) */
     int max_frames;
     
+    /** Check every frame against the reference interpreter (see lockstep.h) */
+    bool lockstep;
+    
+    /** Write a per-frame display fingerprint trace to this file (see trace.h) */
+    const char* trace_file;
+    
 } Chip8RunConfig;
 
 /**
@@ -250,7 +292,9 @@ typedef struct Chip8RunConfig {
     .debug = false, \
     .rom_data = NULL, \
     .rom_size = 0, \
-    .max_frames = 0 \
+    .max_frames = 0, \
+    .lockstep = false, \
+    .trace_file = NULL \
 }
 
 /**
@@ -13,6 +13,14 @@
 #include "context.h"
 #include "instructions.h"
 #include "platform.h"
+#include "audio.h"
+#include "idle.h"
+#include "pacer.h"
+#include "debugger.h"
+#include "disasm.h"
+#include "interpreter.h"
+#include "lockstep.h"
+#include "trace.h"
 #include "settings.h"
 #include "menu.h"
 
@@ -110,16 +118,18 @@ void chip8_clear_function_table(void);
 /**
  * @brief Macro for computed jump (BNNN)
  * 
- * Looks up and calls a function based on computed address.
+ * Tail-calls the function registered at the computed address. Targets
+ * the analyzer missed run in the fallback interpreter instead.
  */
 #define CHIP8_COMPUTED_JUMP(ctx, base_addr) do { \
-    uint16_t _target = (base_addr) + (ctx)->V[0]; \
+    uint16_t _target = ((base_addr) + (ctx)->V[0]) & 0x0FFF; \
     Chip8FuncPtr _func = chip8_lookup_function(_target); \
-    if (_func) { \
+    if (_func && !chip8_smc_block_dirty((ctx), _target)) { \
         _func(ctx); \
     } else { \
-        chip8_panic("Invalid computed jump target", _target); \
+        chip8_interp_run((ctx), _target); \
     } \
+    return; \
 } while(0)
 
 #ifdef __cplusplus
@@ -272,6 +272,9 @@ typedef struct Chip8GameplaySettings {
     /** Key repeat rate in milliseconds (50 - 500) */
     int key_repeat_rate_ms;
     
+    /** Frames to run ahead of the shown frame to hide input lag (0 - 4, 0 = off) */
+    int run_ahead_frames;
+    
     /** Quirk settings for compatibility */
     Chip8Quirks quirks;
 } Chip8GameplaySettings;
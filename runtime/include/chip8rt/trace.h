@@ -0,0 +1,107 @@
+/**
+ * @file trace.h
+ * @brief Display fingerprints and per-frame trace files
+ *
+ * The display is packed to one bit per pixel and fingerprinted with
+ * CRC32C, using the SSE4.2 / ARMv8 CRC instructions when the CPU has them
+ * and a lookup table otherwise. A trace file records one fingerprint per
+ * frame so two runs can be compared frame by frame with
+ * scripts/compare_traces.py.
+ *
+ * Trace file layout (all values little-endian):
+ *   offset 0: "C8TR" magic
+ *   offset 4: uint16 format version (CHIP8_TRACE_VERSION)
+ *   offset 6: uint16 display width, uint16 display height, uint16 reserved
+ *   offset 12: uint32 display CRC32C per frame, until end of file
+ */
+
+#ifndef CHIP8RT_TRACE_H
+#define CHIP8RT_TRACE_H
+
+#include "context.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Trace file format version */
+#define CHIP8_TRACE_VERSION     1
+
+/** Size of the trace file header in bytes */
+#define CHIP8_TRACE_HEADER_SIZE 12
+
+/** Random seed used while tracing, so replays draw the same CXNN values */
+#define CHIP8_TRACE_RANDOM_SEED 0x43385452u
+
+/** Size of the packed (1 bit per pixel) display in bytes */
+#define CHIP8_PACKED_DISPLAY_SIZE (CHIP8_DISPLAY_SIZE / 8)
+
+/* ============================================================================
+ * Fingerprints
+ * ========================================================================== */
+
+/**
+ * @brief Update a CRC32C (Castagnoli) checksum
+ *
+ * Start with crc = 0. Uses hardware CRC instructions when available.
+ *
+ * @param crc Running checksum
+ * @param data Bytes to add
+ * @param len Number of bytes
+ * @return Updated checksum
+ */
+uint32_t chip8_crc32c(uint32_t crc, const void* data, size_t len);
+
+/**
+ * @brief Pack the display to one bit per pixel (pixel i in bit i % 8 of byte i / 8)
+ *
+ * @param ctx CHIP-8 context
+ * @param out Buffer of CHIP8_PACKED_DISPLAY_SIZE bytes
+ */
+void chip8_display_pack(const Chip8Context* ctx, uint8_t* out);
+
+/**
+ * @brief CRC32C of the packed display
+ *
+ * @param ctx CHIP-8 context
+ * @return Display fingerprint
+ */
+uint32_t chip8_display_crc(const Chip8Context* ctx);
+
+/* ============================================================================
+ * Trace Files
+ * ========================================================================== */
+
+/** Opaque trace writer */
+typedef struct Chip8Trace Chip8Trace;
+
+/**
+ * @brief Create a trace file and write its header
+ *
+ * @param path Output file path
+ * @return Trace writer, or NULL if the file could not be created
+ */
+Chip8Trace* chip8_trace_open(const char* path);
+
+/**
+ * @brief Append the current display fingerprint
+ *
+ * @param trace Trace writer
+ * @param ctx CHIP-8 context
+ */
+void chip8_trace_frame(Chip8Trace* trace, const Chip8Context* ctx);
+
+/**
+ * @brief Flush and close a trace file
+ *
+ * @param trace Trace writer (safe to pass NULL)
+ * @return false if any write failed
+ */
+bool chip8_trace_close(Chip8Trace* trace);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CHIP8RT_TRACE_H */
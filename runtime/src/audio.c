@@ -0,0 +1,230 @@
+/**
+ * @file audio.c
+ * @brief Sound event ring and sample-accurate renderer
+ */
+
+#include "chip8rt/audio.h"
+#include <math.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct Chip8AudioRing {
+    Chip8AudioEvent events[CHIP8_AUDIO_RING_SIZE];
+
+    /** Next slot the CPU writes (written by the producer only) */
+    _Atomic uint32_t head;
+
+    /** Next slot the callback reads (written by the consumer only) */
+    _Atomic uint32_t tail;
+
+    /** Frames whose events are all in the ring */
+    _Atomic uint64_t frames_done;
+
+    /* Producer-only state */
+    uint64_t frame;
+    int frame_cycles;
+};
+
+/* ============================================================================
+ * Event Ring
+ * ========================================================================== */
+
+Chip8AudioRing* chip8_audio_ring_create(void) {
+    Chip8AudioRing* ring = (Chip8AudioRing*)calloc(1, sizeof(Chip8AudioRing));
+    if (!ring) {
+        return NULL;
+    }
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->frames_done, 0);
+    return ring;
+}
+
+void chip8_audio_ring_destroy(Chip8AudioRing* ring) {
+    free(ring);
+}
+
+void chip8_audio_begin_frame(Chip8AudioRing* ring, int cycles) {
+    if (ring) {
+        ring->frame_cycles = cycles;
+    }
+}
+
+void chip8_audio_end_frame(Chip8AudioRing* ring) {
+    if (ring) {
+        ring->frame++;
+        atomic_store_explicit(&ring->frames_done, ring->frame, memory_order_release);
+    }
+}
+
+void chip8_audio_record(Chip8Context* ctx, Chip8AudioEventType type) {
+    Chip8AudioRing* ring = ctx->audio_ring;
+    if (!ring) {
+        return;
+    }
+
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail >= CHIP8_AUDIO_RING_SIZE) {
+        return;
+    }
+
+    /* Position in the frame from the cycles already spent */
+    int cycles = ring->frame_cycles;
+    int cycle = cycles - ctx->cycles_remaining;
+    if (cycle < 0) cycle = 0;
+    if (cycle > cycles) cycle = cycles;
+
+    Chip8AudioEvent* event = &ring->events[head & (CHIP8_AUDIO_RING_SIZE - 1)];
+    event->frame = ring->frame;
+    event->cycle = (uint16_t)cycle;
+    event->frame_cycles = (uint16_t)cycles;
+    event->type = (uint8_t)type;
+    event->value = type == CHIP8_AUDIO_EVENT_PITCH ? ctx->audio_pitch
+                                                   : (uint8_t)(ctx->sound_timer > 0);
+    memcpy(event->pattern, ctx->audio_pattern, sizeof(event->pattern));
+
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+/* ============================================================================
+ * Renderer
+ * ========================================================================== */
+
+/* Emulated time of an event, in frames */
+static double event_time(const Chip8AudioEvent* event) {
+    double offset = event->frame_cycles ? (double)event->cycle / event->frame_cycles : 0.0;
+    return (double)event->frame + offset;
+}
+
+static double pattern_rate(uint8_t pitch) {
+    return CHIP8_AUDIO_PATTERN_RATE * pow(2.0, (pitch - CHIP8_AUDIO_DEFAULT_PITCH) / 48.0);
+}
+
+static void apply_event(Chip8AudioRenderer* r, const Chip8AudioEvent* event) {
+    switch (event->type) {
+        case CHIP8_AUDIO_EVENT_TONE:
+            r->tone = event->value != 0;
+            break;
+        case CHIP8_AUDIO_EVENT_PITCH:
+            r->pattern_rate = pattern_rate(event->value);
+            break;
+        case CHIP8_AUDIO_EVENT_PATTERN:
+            memcpy(r->pattern, event->pattern, sizeof(r->pattern));
+            r->has_pattern = true;
+            break;
+        case CHIP8_AUDIO_EVENT_RESET:
+            r->tone = false;
+            r->has_pattern = false;
+            r->pattern_rate = pattern_rate(CHIP8_AUDIO_DEFAULT_PITCH);
+            break;
+        default:
+            break;
+    }
+}
+
+/* Next event from the ring, or NULL if none has been recorded */
+static const Chip8AudioEvent* peek_event(Chip8AudioRenderer* r, Chip8AudioRing* ring) {
+    if (r->has_pending) {
+        return &r->pending;
+    }
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (tail == head) {
+        return NULL;
+    }
+    r->pending = ring->events[tail & (CHIP8_AUDIO_RING_SIZE - 1)];
+    r->has_pending = true;
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+    return &r->pending;
+}
+
+static float voice_sample(Chip8AudioRenderer* r, const Chip8AudioVoice* voice, int sample_rate) {
+    const float amplitude = voice->volume;
+    float value;
+
+    if (r->has_pattern) {
+        unsigned bit = (unsigned)r->pattern_phase & 127;
+        value = (r->pattern[bit >> 3] >> (7 - (bit & 7))) & 1 ? amplitude : -amplitude;
+        r->pattern_phase += r->pattern_rate / sample_rate;
+        if (r->pattern_phase >= 128.0) {
+            r->pattern_phase -= 128.0;
+        }
+        return value;
+    }
+
+    float phase = r->phase;
+    switch (voice->waveform) {
+        case CHIP8_WAVE_SINE:
+            value = sinf(phase * 2.0f * 3.14159f) * amplitude;
+            break;
+        case CHIP8_WAVE_TRIANGLE:
+            value = (2.0f * fabsf(2.0f * (phase - floorf(phase + 0.5f))) - 1.0f) * amplitude;
+            break;
+        case CHIP8_WAVE_SAWTOOTH:
+            value = (2.0f * (phase - floorf(phase + 0.5f))) * amplitude;
+            break;
+        case CHIP8_WAVE_NOISE:
+            r->noise ^= r->noise << 13;
+            r->noise ^= r->noise >> 17;
+            r->noise ^= r->noise << 5;
+            value = ((float)(r->noise >> 8) / 16777215.0f * 2.0f - 1.0f) * amplitude * 0.5f;
+            break;
+        case CHIP8_WAVE_SQUARE:
+        default:
+            value = phase < 0.5f ? amplitude : -amplitude;
+            break;
+    }
+
+    r->phase += (float)voice->frequency / (float)sample_rate;
+    if (r->phase >= 1.0f) {
+        r->phase -= 1.0f;
+    }
+    return value;
+}
+
+void chip8_audio_renderer_init(Chip8AudioRenderer* renderer) {
+    memset(renderer, 0, sizeof(*renderer));
+    renderer->pattern_rate = pattern_rate(CHIP8_AUDIO_DEFAULT_PITCH);
+    renderer->noise = 0x2545F491u;
+}
+
+void chip8_audio_render(Chip8AudioRenderer* renderer, Chip8AudioRing* ring,
+                        const Chip8AudioVoice* voice,
+                        float* out, int samples, int sample_rate) {
+    Chip8AudioRenderer* r = renderer;
+
+    if (!ring || sample_rate <= 0) {
+        memset(out, 0, (size_t)samples * sizeof(float));
+        return;
+    }
+
+    /*
+     * Play one buffer behind the newest complete frame. Falling further
+     * behind (a stall) or running ahead (a pause, fast-forward) snaps the
+     * position back; events skipped over are applied at the first sample.
+     */
+    double step = (double)CHIP8_TIMER_FREQ_HZ / sample_rate;
+    double done = (double)atomic_load_explicit(&ring->frames_done, memory_order_acquire);
+    double target = done - samples * step;
+    if (!r->synced || fabs(r->position - target) > CHIP8_AUDIO_MAX_DRIFT) {
+        r->position = target;
+        r->synced = true;
+    }
+
+    for (int i = 0; i < samples; ++i) {
+        const Chip8AudioEvent* event;
+        while ((event = peek_event(r, ring)) && event_time(event) <= r->position) {
+            apply_event(r, event);
+            r->has_pending = false;
+        }
+
+        out[i] = (r->tone && voice->volume > 0.0f) ? voice_sample(r, voice, sample_rate) : 0.0f;
+
+        /* Never play past what the CPU has finished */
+        if (r->position + step <= done) {
+            r->position += step;
+        }
+    }
+}
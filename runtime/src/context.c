@@ -4,9 +4,14 @@
  */
 
 #include "chip8rt/context.h"
+#include "chip8rt/audio.h"
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
 /* Built-in 4x5 font sprites (0-F) */
 static const uint8_t CHIP8_FONT[80] = {
     0xF0, 0x90, 0x90, 0x90, 0xF0, /* 0 */
@@ -27,8 +32,23 @@ static const uint8_t CHIP8_FONT[80] = {
     0xF0, 0x80, 0xF0, 0x80, 0x80  /* F */
 };
 
+/* Allocate a zeroed context whose hot header starts a cache line */
+static Chip8Context* context_alloc(void) {
+    size_t size = (sizeof(Chip8Context) + CHIP8_CACHE_LINE_SIZE - 1) &
+                  ~(size_t)(CHIP8_CACHE_LINE_SIZE - 1);
+#ifdef _WIN32
+    Chip8Context* ctx = (Chip8Context*)_aligned_malloc(size, CHIP8_CACHE_LINE_SIZE);
+#else
+    Chip8Context* ctx = (Chip8Context*)aligned_alloc(CHIP8_CACHE_LINE_SIZE, size);
+#endif
+    if (ctx) {
+        memset(ctx, 0, size);
+    }
+    return ctx;
+}
+
 Chip8Context* chip8_context_create(void) {
-    Chip8Context* ctx = (Chip8Context*)calloc(1, sizeof(Chip8Context));
+    Chip8Context* ctx = context_alloc();
     if (!ctx) {
         return NULL;
     }
@@ -40,13 +60,19 @@ Chip8Context* chip8_context_create(void) {
     ctx->PC = CHIP8_PROGRAM_START;
     ctx->running = true;
     ctx->last_key_released = -1;
+    ctx->rng_state = CHIP8_RNG_DEFAULT_STATE;
+    ctx->audio_pitch = CHIP8_AUDIO_DEFAULT_PITCH;
     
     return ctx;
 }
 
 void chip8_context_destroy(Chip8Context* ctx) {
     if (ctx) {
+#ifdef _WIN32
+        _aligned_free(ctx);
+#else
         free(ctx);
+#endif
     }
 }
 
@@ -61,9 +87,12 @@ void chip8_context_reset(Chip8Context* ctx) {
     ctx->PC = CHIP8_PROGRAM_START;
     ctx->SP = 0;
     
-    /* Clear timers */
+    /* Clear timers and sound */
     ctx->delay_timer = 0;
     ctx->sound_timer = 0;
+    ctx->audio_pitch = CHIP8_AUDIO_DEFAULT_PITCH;
+    memset(ctx->audio_pattern, 0, sizeof(ctx->audio_pattern));
+    chip8_audio_record(ctx, CHIP8_AUDIO_EVENT_RESET);
     
     /* Clear stack */
     memset(ctx->stack, 0, sizeof(ctx->stack));
@@ -78,12 +107,23 @@ void chip8_context_reset(Chip8Context* ctx) {
     
     /* Reset runtime state */
     ctx->running = true;
+    ctx->reset_requested = false;
     ctx->waiting_for_key = false;
     ctx->key_wait_register = 0;
-    
+    ctx->should_yield = false;
+    if (ctx->rng_state == 0) {
+        ctx->rng_state = CHIP8_RNG_DEFAULT_STATE;
+    }
+
+    /* Drop interpreter and SMC state (watch_map stays attached) */
+    ctx->smc_pending = false;
+    ctx->in_interpreter = false;
+    memset(ctx->smc_dirty, 0, sizeof(ctx->smc_dirty));
+
     /* Reset stats */
     ctx->instruction_count = 0;
     ctx->frame_count = 0;
+    ctx->block_trace_count = 0;
 }
 
 bool chip8_context_load_program(Chip8Context* ctx, 
@@ -103,3 +143,17 @@ bool chip8_context_load_program(Chip8Context* ctx,
     
     return true;
 }
+
+uint64_t chip8_context_virtual_time_us(const Chip8Context* ctx) {
+    return ctx->virtual_frames * 1000000ull / CHIP8_TIMER_FREQ_HZ;
+}
+
+int chip8_context_recent_blocks(const Chip8Context* ctx, uint16_t* out, int max) {
+    uint32_t count = ctx->block_trace_count;
+    int n = count < CHIP8_BLOCK_TRACE_SIZE ? (int)count : CHIP8_BLOCK_TRACE_SIZE;
+    if (n > max) n = max;
+    for (int i = 0; i < n; ++i) {
+        out[i] = ctx->block_trace[(count - 1 - (uint32_t)i) & (CHIP8_BLOCK_TRACE_SIZE - 1)];
+    }
+    return n;
+}
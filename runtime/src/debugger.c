@@ -0,0 +1,95 @@
+/**
+ * @file debugger.c
+ * @brief Breakpoints, watchpoints and block stepping
+ */
+
+#include "chip8rt/debugger.h"
+#include "chip8rt/platform.h"
+#include "chip8rt/runtime.h"
+
+static Chip8Debugger g_debugger;
+
+Chip8Debugger* chip8_debugger_get(void) {
+    return &g_debugger;
+}
+
+/* Set or clear one address in a map, keeping its count */
+static void set_point(uint8_t* map, int* count, uint16_t addr, bool enabled) {
+    addr &= 0x0FFF;
+    if (enabled && !map[addr]) {
+        map[addr] = 1;
+        (*count)++;
+    } else if (!enabled && map[addr]) {
+        map[addr] = 0;
+        (*count)--;
+    }
+}
+
+void chip8_debugger_set_breakpoint(Chip8Debugger* dbg, uint16_t addr, bool enabled) {
+    set_point(dbg->breakpoints, &dbg->num_breakpoints, addr, enabled);
+}
+
+void chip8_debugger_set_watchpoint(Chip8Debugger* dbg, uint16_t addr, bool enabled) {
+    set_point(dbg->watchpoints, &dbg->num_watchpoints, addr, enabled);
+}
+
+void chip8_debugger_pause(Chip8Debugger* dbg) {
+    dbg->stop = true;
+}
+
+void chip8_debugger_resume(Chip8Debugger* dbg, bool step) {
+    dbg->paused = false;
+    dbg->stop = step;
+}
+
+void chip8_debugger_break(Chip8Context* ctx, uint16_t addr) {
+    Chip8Debugger* dbg = ctx->debugger;
+    Chip8Platform* platform = chip8_get_platform();
+    uint64_t period = 1000000 / CHIP8_TIMER_FREQ_HZ;
+
+    dbg->stop = false;
+    dbg->paused = true;
+    dbg->break_pc = addr & 0x0FFF;
+    dbg->breaks++;
+    ctx->PC = dbg->break_pc;
+
+    if (dbg->watch_hit) {
+        chip8_debug("Stopped at 0x%03X after a store to 0x%03X", dbg->break_pc, dbg->watch_addr);
+    } else {
+        chip8_debug("Stopped at 0x%03X", dbg->break_pc);
+    }
+
+    while (dbg->paused && ctx->running && !platform->should_quit(ctx)) {
+        uint64_t frame_start = platform->get_time_us();
+        platform->poll_events(ctx);
+        platform->render(ctx);
+
+        /* A reset from the overlay: end this frame, the runtime restarts the game */
+        if (ctx->reset_requested) {
+            ctx->cycles_remaining = 0;
+            break;
+        }
+
+        uint64_t elapsed = platform->get_time_us() - frame_start;
+        if (elapsed < period) {
+            platform->sleep_us(period - elapsed);
+        }
+    }
+
+    dbg->paused = false;
+    dbg->watch_hit = false;
+}
+
+void chip8_debugger_check_write(Chip8Context* ctx, uint16_t addr, uint16_t len) {
+    Chip8Debugger* dbg = ctx->debugger;
+    for (uint16_t i = 0; i < len; ++i) {
+        uint16_t a = (addr + i) & 0x0FFF;
+        if (dbg->watchpoints[a]) {
+            /* Stop once the storing block is done, at the next block entry */
+            dbg->watch_hit = true;
+            dbg->watch_addr = a;
+            dbg->stop = true;
+            return;
+        }
+    }
+}
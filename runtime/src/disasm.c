@@ -0,0 +1,142 @@
+/**
+ * @file disasm.c
+ * @brief CHIP-8 disassembler for the runtime's debug views
+ */
+
+#include "chip8rt/disasm.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Operand layouts */
+typedef enum DisasmArgs {
+    ARGS_NONE,      /* CLS */
+    ARGS_SYS,       /* 0x123 (ignored) */
+    ARGS_NNN,       /* 0x123 */
+    ARGS_V0_NNN,    /* V0, 0x123 */
+    ARGS_I_NNN,     /* I, 0x123 */
+    ARGS_X_NN,      /* V1, 0x23 */
+    ARGS_X_Y,       /* V1, V2 */
+    ARGS_X_Y_N,     /* V1, V2, 3 */
+    ARGS_X,         /* V1 */
+    ARGS_X_DT,      /* V1, DT */
+    ARGS_X_K,       /* V1, K */
+    ARGS_DT_X,      /* DT, V1 */
+    ARGS_ST_X,      /* ST, V1 */
+    ARGS_I_X,       /* I, V1 */
+    ARGS_F_X,       /* F, V1 */
+    ARGS_B_X,       /* B, V1 */
+    ARGS_MEM_X,     /* [I], V1 */
+    ARGS_X_MEM,     /* V1, [I] */
+    ARGS_AUDIO,     /* AUDIO, [I] */
+    ARGS_PITCH_X    /* PITCH, V1 */
+} DisasmArgs;
+
+typedef struct DisasmEntry {
+    uint16_t mask;
+    uint16_t match;
+    const char* mnemonic;
+    DisasmArgs args;
+} DisasmEntry;
+
+/* First match wins, so exact opcodes come before the groups they belong to */
+static const DisasmEntry DISASM_TABLE[] = {
+    { 0xFFFF, 0x00E0, "CLS",  ARGS_NONE },
+    { 0xFFFF, 0x00EE, "RET",  ARGS_NONE },
+    { 0xF000, 0x0000, "SYS",  ARGS_SYS },
+    { 0xF000, 0x1000, "JP",   ARGS_NNN },
+    { 0xF000, 0x2000, "CALL", ARGS_NNN },
+    { 0xF000, 0x3000, "SE",   ARGS_X_NN },
+    { 0xF000, 0x4000, "SNE",  ARGS_X_NN },
+    { 0xF00F, 0x5000, "SE",   ARGS_X_Y },
+    { 0xF000, 0x6000, "LD",   ARGS_X_NN },
+    { 0xF000, 0x7000, "ADD",  ARGS_X_NN },
+    { 0xF00F, 0x8000, "LD",   ARGS_X_Y },
+    { 0xF00F, 0x8001, "OR",   ARGS_X_Y },
+    { 0xF00F, 0x8002, "AND",  ARGS_X_Y },
+    { 0xF00F, 0x8003, "XOR",  ARGS_X_Y },
+    { 0xF00F, 0x8004, "ADD",  ARGS_X_Y },
+    { 0xF00F, 0x8005, "SUB",  ARGS_X_Y },
+    { 0xF00F, 0x8006, "SHR",  ARGS_X },
+    { 0xF00F, 0x8007, "SUBN", ARGS_X_Y },
+    { 0xF00F, 0x800E, "SHL",  ARGS_X },
+    { 0xF00F, 0x9000, "SNE",  ARGS_X_Y },
+    { 0xF000, 0xA000, "LD",   ARGS_I_NNN },
+    { 0xF000, 0xB000, "JP",   ARGS_V0_NNN },
+    { 0xF000, 0xC000, "RND",  ARGS_X_NN },
+    { 0xF000, 0xD000, "DRW",  ARGS_X_Y_N },
+    { 0xF0FF, 0xE09E, "SKP",  ARGS_X },
+    { 0xF0FF, 0xE0A1, "SKNP", ARGS_X },
+    { 0xFFFF, 0xF002, "LD",   ARGS_AUDIO },
+    { 0xF0FF, 0xF007, "LD",   ARGS_X_DT },
+    { 0xF0FF, 0xF00A, "LD",   ARGS_X_K },
+    { 0xF0FF, 0xF015, "LD",   ARGS_DT_X },
+    { 0xF0FF, 0xF018, "LD",   ARGS_ST_X },
+    { 0xF0FF, 0xF01E, "ADD",  ARGS_I_X },
+    { 0xF0FF, 0xF029, "LD",   ARGS_F_X },
+    { 0xF0FF, 0xF033, "LD",   ARGS_B_X },
+    { 0xF0FF, 0xF03A, "LD",   ARGS_PITCH_X },
+    { 0xF0FF, 0xF055, "LD",   ARGS_MEM_X },
+    { 0xF0FF, 0xF065, "LD",   ARGS_X_MEM },
+};
+
+#define DISASM_TABLE_SIZE (sizeof(DISASM_TABLE) / sizeof(DISASM_TABLE[0]))
+
+int chip8_disassemble(uint16_t opcode, char* buf, size_t size) {
+    const DisasmEntry* entry = NULL;
+    for (size_t i = 0; i < DISASM_TABLE_SIZE; ++i) {
+        if ((opcode & DISASM_TABLE[i].mask) == DISASM_TABLE[i].match) {
+            entry = &DISASM_TABLE[i];
+            break;
+        }
+    }
+    if (!entry) {
+        return snprintf(buf, size, "???  (unknown)");
+    }
+
+    unsigned x = (opcode >> 8) & 0xF;
+    unsigned y = (opcode >> 4) & 0xF;
+    unsigned n = opcode & 0xF;
+    unsigned nn = opcode & 0xFF;
+    unsigned nnn = opcode & 0xFFF;
+    const char* m = entry->mnemonic;
+
+    switch (entry->args) {
+        case ARGS_NONE:    return snprintf(buf, size, "%s", m);
+        case ARGS_SYS:     return snprintf(buf, size, "%-5s0x%X (ignored)", m, nnn);
+        case ARGS_NNN:     return snprintf(buf, size, "%-5s0x%X", m, nnn);
+        case ARGS_V0_NNN:  return snprintf(buf, size, "%-5sV0, 0x%X", m, nnn);
+        case ARGS_I_NNN:   return snprintf(buf, size, "%-5sI, 0x%X", m, nnn);
+        case ARGS_X_NN:    return snprintf(buf, size, "%-5sV%X, 0x%X", m, x, nn);
+        case ARGS_X_Y:     return snprintf(buf, size, "%-5sV%X, V%X", m, x, y);
+        case ARGS_X_Y_N:   return snprintf(buf, size, "%-5sV%X, V%X, %u", m, x, y, n);
+        case ARGS_X:       return snprintf(buf, size, "%-5sV%X", m, x);
+        case ARGS_X_DT:    return snprintf(buf, size, "%-5sV%X, DT", m, x);
+        case ARGS_X_K:     return snprintf(buf, size, "%-5sV%X, K", m, x);
+        case ARGS_DT_X:    return snprintf(buf, size, "%-5sDT, V%X", m, x);
+        case ARGS_ST_X:    return snprintf(buf, size, "%-5sST, V%X", m, x);
+        case ARGS_I_X:     return snprintf(buf, size, "%-5sI, V%X", m, x);
+        case ARGS_F_X:     return snprintf(buf, size, "%-5sF, V%X", m, x);
+        case ARGS_B_X:     return snprintf(buf, size, "%-5sB, V%X", m, x);
+        case ARGS_MEM_X:   return snprintf(buf, size, "%-5s[I], V%X", m, x);
+        case ARGS_X_MEM:   return snprintf(buf, size, "%-5sV%X, [I]", m, x);
+        case ARGS_AUDIO:   return snprintf(buf, size, "%-5sAUDIO, [I]", m);
+        case ARGS_PITCH_X: return snprintf(buf, size, "%-5sPITCH, V%X", m, x);
+    }
+    return snprintf(buf, size, "???  (unknown)");
+}
+
+void chip8_disasm_cache_clear(Chip8DisasmCache* cache) {
+    memset(cache->valid, 0, sizeof(cache->valid));
+}
+
+const char* chip8_disasm_cached(Chip8DisasmCache* cache, const uint8_t* memory, uint16_t addr) {
+    addr &= 0x0FFF;
+    uint16_t opcode = (uint16_t)((memory[addr] << 8) | memory[(addr + 1) & 0x0FFF]);
+
+    if (!cache->valid[addr] || cache->opcode[addr] != opcode) {
+        chip8_disassemble(opcode, cache->text[addr], CHIP8_DISASM_MAX_LEN);
+        cache->opcode[addr] = opcode;
+        cache->valid[addr] = true;
+    }
+    return cache->text[addr];
+}
@@ -0,0 +1,77 @@
+/**
+ * @file idle.c
+ * @brief Event-driven host idling
+ */
+
+#include "chip8rt/idle.h"
+#include "chip8rt/platform.h"
+#include "chip8rt/runtime.h"
+
+void chip8_idle_init(Chip8IdleScheduler* idle, uint32_t timeout_ms) {
+    idle->redraw = true;
+    idle->active_until_us = 0;
+    idle->timeout_ms = timeout_ms;
+    idle->last_wake = CHIP8_WAKE_FRAME;
+    for (int i = 0; i < CHIP8_WAKE_REASON_COUNT; ++i) {
+        idle->wakes[i] = 0;
+    }
+}
+
+void chip8_idle_invalidate(Chip8IdleScheduler* idle) {
+    idle->redraw = true;
+}
+
+void chip8_idle_animate(Chip8IdleScheduler* idle, uint64_t now_us, uint64_t duration_us) {
+    if (now_us + duration_us > idle->active_until_us) {
+        idle->active_until_us = now_us + duration_us;
+    }
+}
+
+bool chip8_idle_needs_draw(Chip8IdleScheduler* idle, uint64_t now_us) {
+    bool draw = idle->redraw || now_us < idle->active_until_us;
+    idle->redraw = false;
+    return draw;
+}
+
+Chip8WakeReason chip8_idle_wait(Chip8IdleScheduler* idle, Chip8Context* ctx,
+                                uint64_t frame_start_us, uint64_t frame_period_us) {
+    Chip8Platform* platform = chip8_get_platform();
+    uint64_t now = platform->get_time_us();
+    Chip8WakeReason reason;
+
+    if (idle->redraw || now < idle->active_until_us || !platform->wait_event) {
+        uint64_t elapsed = now - frame_start_us;
+        if (elapsed < frame_period_us) {
+            platform->sleep_us(frame_period_us - elapsed);
+        }
+        reason = CHIP8_WAKE_FRAME;
+    } else if (platform->wait_event(ctx, idle->timeout_ms)) {
+        chip8_idle_animate(idle, platform->get_time_us(), CHIP8_IDLE_SETTLE_US);
+        reason = CHIP8_WAKE_INPUT;
+    } else {
+        reason = CHIP8_WAKE_TIMEOUT;
+    }
+
+    idle->last_wake = reason;
+    idle->wakes[reason]++;
+    return reason;
+}
+
+void chip8_idle_report(const Chip8IdleScheduler* idle, const char* name) {
+    chip8_debug("%s idle wakeups: %llu %s, %llu %s, %llu %s", name,
+                (unsigned long long)idle->wakes[CHIP8_WAKE_FRAME],
+                chip8_wake_reason_name(CHIP8_WAKE_FRAME),
+                (unsigned long long)idle->wakes[CHIP8_WAKE_INPUT],
+                chip8_wake_reason_name(CHIP8_WAKE_INPUT),
+                (unsigned long long)idle->wakes[CHIP8_WAKE_TIMEOUT],
+                chip8_wake_reason_name(CHIP8_WAKE_TIMEOUT));
+}
+
+const char* chip8_wake_reason_name(Chip8WakeReason reason) {
+    switch (reason) {
+        case CHIP8_WAKE_FRAME:   return "frame";
+        case CHIP8_WAKE_INPUT:   return "input";
+        case CHIP8_WAKE_TIMEOUT: return "timeout";
+        default:                 return "unknown";
+    }
+}
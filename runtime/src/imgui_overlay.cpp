@@ -206,29 +206,47 @@ static void render_debug_stack(Chip8Context* ctx) {
 
 static void render_debug_memory(Chip8Context* ctx) {
     if (ImGui::CollapsingHeader("Memory Viewer")) {
+        const int bytes_per_row = 16;
+        const int rows = CHIP8_MEMORY_SIZE / bytes_per_row;
+        
         static int mem_addr = 0x200;
-        ImGui::InputInt("Address", &mem_addr, 16, 256);
+        bool jump = ImGui::InputInt("Address", &mem_addr, 16, 256);
         mem_addr = (mem_addr < 0) ? 0 : (mem_addr > 0xFFF) ? 0xFFF : mem_addr;
         
-        /* Show 16 rows of 16 bytes */
+        /* All of memory, laying out only the visible rows */
         ImGui::BeginChild("MemView", ImVec2(0, 200), true);
-        for (int row = 0; row < 16; row++) {
-            int addr = (mem_addr & ~0xF) + row * 16;
-            if (addr > 0xFFF) break;
-            
-            ImGui::Text("%04X:", addr);
-            ImGui::SameLine();
-            
-            for (int col = 0; col < 16; col++) {
-                int a = addr + col;
-                if (a <= 0xFFF) {
+        float row_height = ImGui::GetTextLineHeightWithSpacing();
+        if (jump) {
+            ImGui::SetScrollY((mem_addr / bytes_per_row) * row_height);
+        }
+        
+        ImGuiListClipper clipper;
+        clipper.Begin(rows, row_height);
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+                int addr = row * bytes_per_row;
+                
+                /* One text item per row, unless the PC is in it */
+                if (ctx->PC + 1 < addr || ctx->PC >= addr + bytes_per_row) {
+                    char line[8 + bytes_per_row * 3];
+                    int len = snprintf(line, sizeof(line), "%04X:", addr);
+                    for (int col = 0; col < bytes_per_row; col++) {
+                        len += snprintf(line + len, sizeof(line) - len, " %02X", ctx->memory[addr + col]);
+                    }
+                    ImGui::TextUnformatted(line);
+                    continue;
+                }
+                
+                ImGui::Text("%04X:", addr);
+                for (int col = 0; col < bytes_per_row; col++) {
+                    int a = addr + col;
+                    ImGui::SameLine();
                     if (a == ctx->PC || a == ctx->PC + 1) {
                         ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%02X", ctx->memory[a]);
                     } else {
                         ImGui::Text("%02X", ctx->memory[a]);
                     }
                 }
-                if (col < 15) ImGui::SameLine();
             }
         }
         ImGui::EndChild();
@@ -237,89 +255,121 @@ static void render_debug_memory(Chip8Context* ctx) {
 
 static void render_debug_disassembly(Chip8Context* ctx) {
     if (ImGui::CollapsingHeader("Disassembly", ImGuiTreeNodeFlags_DefaultOpen)) {
-        ImGui::BeginChild("Disasm", ImVec2(0, 150), true);
+        static Chip8DisasmCache cache;
+        static bool follow_pc = true;
+        static uint16_t last_pc = 0xFFFF;
+        ImGui::Checkbox("Follow PC", &follow_pc);
         
-        /* Show instructions around PC */
-        int start_pc = ctx->PC - 10;
-        if (start_pc < 0x200) start_pc = 0x200;
+        /* Every instruction slot in memory, decoding only the visible lines */
+        ImGui::BeginChild("Disasm", ImVec2(0, 150), true);
+        float line_height = ImGui::GetTextLineHeightWithSpacing();
+        if (follow_pc && ctx->PC != last_pc) {
+            float center = (ctx->PC / 2) * line_height - ImGui::GetWindowHeight() / 2;
+            ImGui::SetScrollY(center > 0 ? center : 0);
+            last_pc = ctx->PC;
+        }
         
-        for (int addr = start_pc; addr < ctx->PC + 20 && addr < 0xFFF; addr += 2) {
-            uint16_t opcode = (ctx->memory[addr] << 8) | ctx->memory[addr + 1];
-            
-            /* Simple disassembly */
-            char disasm[64];
-            uint8_t x = (opcode >> 8) & 0x0F;
-            uint8_t y = (opcode >> 4) & 0x0F;
-            uint8_t n = opcode & 0x0F;
-            uint8_t nn = opcode & 0xFF;
-            uint16_t nnn = opcode & 0x0FFF;
-            
-            switch (opcode >> 12) {
-                case 0x0:
-                    if (opcode == 0x00E0) snprintf(disasm, sizeof(disasm), "CLS");
-                    else if (opcode == 0x00EE) snprintf(disasm, sizeof(disasm), "RET");
-                    else snprintf(disasm, sizeof(disasm), "SYS %03X", nnn);
-                    break;
-                case 0x1: snprintf(disasm, sizeof(disasm), "JP %03X", nnn); break;
-                case 0x2: snprintf(disasm, sizeof(disasm), "CALL %03X", nnn); break;
-                case 0x3: snprintf(disasm, sizeof(disasm), "SE V%X, %02X", x, nn); break;
-                case 0x4: snprintf(disasm, sizeof(disasm), "SNE V%X, %02X", x, nn); break;
-                case 0x5: snprintf(disasm, sizeof(disasm), "SE V%X, V%X", x, y); break;
-                case 0x6: snprintf(disasm, sizeof(disasm), "LD V%X, %02X", x, nn); break;
-                case 0x7: snprintf(disasm, sizeof(disasm), "ADD V%X, %02X", x, nn); break;
-                case 0x8:
-                    switch (n) {
-                        case 0x0: snprintf(disasm, sizeof(disasm), "LD V%X, V%X", x, y); break;
-                        case 0x1: snprintf(disasm, sizeof(disasm), "OR V%X, V%X", x, y); break;
-                        case 0x2: snprintf(disasm, sizeof(disasm), "AND V%X, V%X", x, y); break;
-                        case 0x3: snprintf(disasm, sizeof(disasm), "XOR V%X, V%X", x, y); break;
-                        case 0x4: snprintf(disasm, sizeof(disasm), "ADD V%X, V%X", x, y); break;
-                        case 0x5: snprintf(disasm, sizeof(disasm), "SUB V%X, V%X", x, y); break;
-                        case 0x6: snprintf(disasm, sizeof(disasm), "SHR V%X", x); break;
-                        case 0x7: snprintf(disasm, sizeof(disasm), "SUBN V%X, V%X", x, y); break;
-                        case 0xE: snprintf(disasm, sizeof(disasm), "SHL V%X", x); break;
-                        default: snprintf(disasm, sizeof(disasm), "??? %04X", opcode); break;
-                    }
-                    break;
-                case 0x9: snprintf(disasm, sizeof(disasm), "SNE V%X, V%X", x, y); break;
-                case 0xA: snprintf(disasm, sizeof(disasm), "LD I, %03X", nnn); break;
-                case 0xB: snprintf(disasm, sizeof(disasm), "JP V0, %03X", nnn); break;
-                case 0xC: snprintf(disasm, sizeof(disasm), "RND V%X, %02X", x, nn); break;
-                case 0xD: snprintf(disasm, sizeof(disasm), "DRW V%X, V%X, %X", x, y, n); break;
-                case 0xE:
-                    if (nn == 0x9E) snprintf(disasm, sizeof(disasm), "SKP V%X", x);
-                    else if (nn == 0xA1) snprintf(disasm, sizeof(disasm), "SKNP V%X", x);
-                    else snprintf(disasm, sizeof(disasm), "??? %04X", opcode);
-                    break;
-                case 0xF:
-                    switch (nn) {
-                        case 0x07: snprintf(disasm, sizeof(disasm), "LD V%X, DT", x); break;
-                        case 0x0A: snprintf(disasm, sizeof(disasm), "LD V%X, K", x); break;
-                        case 0x15: snprintf(disasm, sizeof(disasm), "LD DT, V%X", x); break;
-                        case 0x18: snprintf(disasm, sizeof(disasm), "LD ST, V%X", x); break;
-                        case 0x1E: snprintf(disasm, sizeof(disasm), "ADD I, V%X", x); break;
-                        case 0x29: snprintf(disasm, sizeof(disasm), "LD F, V%X", x); break;
-                        case 0x33: snprintf(disasm, sizeof(disasm), "LD B, V%X", x); break;
-                        case 0x55: snprintf(disasm, sizeof(disasm), "LD [I], V%X", x); break;
-                        case 0x65: snprintf(disasm, sizeof(disasm), "LD V%X, [I]", x); break;
-                        default: snprintf(disasm, sizeof(disasm), "??? %04X", opcode); break;
-                    }
-                    break;
-                default:
-                    snprintf(disasm, sizeof(disasm), "??? %04X", opcode);
-                    break;
+        /* Lines follow the PC's alignment, so code at odd addresses decodes too */
+        int align = ctx->PC & 1;
+        ImGuiListClipper clipper;
+        clipper.Begin(CHIP8_MEMORY_SIZE / 2, line_height);
+        while (clipper.Step()) {
+            for (int line = clipper.DisplayStart; line < clipper.DisplayEnd; line++) {
+                int addr = line * 2 + align;
+                uint16_t opcode = (ctx->memory[addr] << 8) | ctx->memory[(addr + 1) & 0x0FFF];
+                const char* disasm = chip8_disasm_cached(&cache, ctx->memory, (uint16_t)addr);
+                
+                char mark = (ctx->debugger && ctx->debugger->breakpoints[addr]) ? '*' : ' ';
+                if (addr == ctx->PC) {
+                    ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), ">%c%04X: %04X  %s", mark, addr, opcode, disasm);
+                } else {
+                    ImGui::Text(" %c%04X: %04X  %s", mark, addr, opcode, disasm);
+                }
             }
-            
-            if (addr == ctx->PC) {
-                ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "> %04X: %04X  %s", addr, opcode, disasm);
+        }
+        ImGui::EndChild();
+    }
+}
+
+static void render_debug_trace(Chip8Context* ctx) {
+    if (ImGui::CollapsingHeader("Execution Trace")) {
+        uint16_t blocks[CHIP8_BLOCK_TRACE_SIZE];
+        int count = chip8_context_recent_blocks(ctx, blocks, CHIP8_BLOCK_TRACE_SIZE);
+        if (count == 0) {
+            ImGui::TextDisabled("(recompile with --block-trace)");
+            return;
+        }
+        
+        /* Newest first, with repeats of a block (loops) folded into one line */
+        ImGui::BeginChild("Trace", ImVec2(0, 150), true);
+        for (int i = 0; i < count;) {
+            int run = 1;
+            while (i + run < count && blocks[i + run] == blocks[i]) run++;
+            const char* marker = (i == 0) ? ">" : " ";
+            if (run > 1) {
+                ImGui::Text("%s %04X  x%d", marker, blocks[i], run);
             } else {
-                ImGui::Text("  %04X: %04X  %s", addr, opcode, disasm);
+                ImGui::Text("%s %04X", marker, blocks[i]);
             }
+            i += run;
         }
         ImGui::EndChild();
     }
 }
 
+static void render_debug_breakpoints(Chip8Context* ctx) {
+    if (ImGui::CollapsingHeader("Breakpoints")) {
+        Chip8Debugger* dbg = ctx->debugger;
+        if (!dbg) {
+            ImGui::TextDisabled("(debug builds only)");
+            return;
+        }
+        
+        /* Run control: stepping stops at the next block entry */
+        if (dbg->paused) {
+            if (dbg->watch_hit) {
+                ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "Stopped at %04X (store to %04X)",
+                                   dbg->break_pc, dbg->watch_addr);
+            } else {
+                ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "Stopped at %04X", dbg->break_pc);
+            }
+            if (ImGui::Button("Continue")) chip8_debugger_resume(dbg, false);
+            ImGui::SameLine();
+            if (ImGui::Button("Step Block")) chip8_debugger_resume(dbg, true);
+        } else {
+            ImGui::Text("Running");
+            if (ImGui::Button("Pause")) chip8_debugger_pause(dbg);
+        }
+        
+        ImGui::Separator();
+        
+        static int point_addr = 0x200;
+        const int step = 2, step_fast = 16;
+        ImGui::InputScalar("Address##point", ImGuiDataType_S32, &point_addr, &step, &step_fast,
+                           "%03X", ImGuiInputTextFlags_CharsHexadecimal);
+        point_addr &= 0x0FFF;
+        if (ImGui::Button("Break")) chip8_debugger_set_breakpoint(dbg, (uint16_t)point_addr, true);
+        ImGui::SameLine();
+        if (ImGui::Button("Watch")) chip8_debugger_set_watchpoint(dbg, (uint16_t)point_addr, true);
+        
+        /* Current points, each removable */
+        for (int addr = 0; addr < CHIP8_MEMORY_SIZE; addr++) {
+            bool bp = dbg->breakpoints[addr] != 0;
+            bool wp = dbg->watchpoints[addr] != 0;
+            if (!bp && !wp) continue;
+            
+            ImGui::PushID(addr);
+            if (ImGui::SmallButton("x")) {
+                chip8_debugger_set_breakpoint(dbg, (uint16_t)addr, false);
+                chip8_debugger_set_watchpoint(dbg, (uint16_t)addr, false);
+            }
+            ImGui::SameLine();
+            ImGui::Text("%04X  %s%s", addr, bp ? "break " : "", wp ? "watch" : "");
+            ImGui::PopID();
+        }
+    }
+}
+
 static void render_debug_keys(Chip8Context* ctx) {
     if (ImGui::CollapsingHeader("Keypad State")) {
         ImGui::Columns(4, "keys", false);
@@ -349,6 +399,8 @@ static void render_debug_overlay(Chip8Context* ctx, Chip8OverlayState* state) {
         render_debug_stack(ctx);
         render_debug_keys(ctx);
         render_debug_disassembly(ctx);
+        render_debug_trace(ctx);
+        render_debug_breakpoints(ctx);
         render_debug_memory(ctx);
     }
     ImGui::End();
@@ -466,6 +518,12 @@ static void render_settings_window(Chip8Settings* settings, Chip8OverlayState* s
                 changed = true;
             }
             
+            int run_ahead = settings->gameplay.run_ahead_frames;
+            if (ImGui::SliderInt("Run-Ahead (frames)", &run_ahead, 0, 4)) {
+                settings->gameplay.run_ahead_frames = run_ahead;
+                changed = true;
+            }
+            
             bool quirks = settings->gameplay.quirks.shift_uses_vy;
             if (ImGui::Checkbox("Shift uses VY (COSMAC)", &quirks)) {
                 settings->gameplay.quirks.shift_uses_vy = quirks;
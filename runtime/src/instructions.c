@@ -3,12 +3,19 @@
  * @brief CHIP-8 instruction helper implementations
  */
 
+/* Define the out-of-line helpers, not the inline expansions */
+#undef CHIP8_INLINE_HELPERS
+#define CHIP8_INLINE_HELPERS 0
+
 #include "chip8rt/instructions.h"
+#include "chip8rt/audio.h"
+#include "chip8rt/interpreter.h"
+#include "chip8rt/platform.h"
 #include <stdlib.h>
 #include <string.h>
 
-/* Random number generator state */
-static uint32_t rng_state = 0x12345678;
+/* Generator for chip8_random_byte() when no program is running */
+static uint32_t g_rng_fallback = CHIP8_RNG_DEFAULT_STATE;
 
 void chip8_clear_screen(Chip8Context* ctx) {
     memset(ctx->display, 0, sizeof(ctx->display));
@@ -58,70 +65,54 @@ void chip8_draw_sprite(Chip8Context* ctx, uint8_t vx, uint8_t vy, uint8_t height
 }
 
 bool chip8_key_pressed(Chip8Context* ctx, uint8_t key) {
-    /* Mask to lower nibble as per original CHIP-8 behavior (CTR errata) */
-    return ctx->keys[key & 0xF];
+    return chip8_key_pressed_inline(ctx, key);
 }
 
 void chip8_wait_key(Chip8Context* ctx, uint8_t reg) {
     /* 
-     * This blocks until a key is pressed and released.
-     * The main loop should check waiting_for_key and handle input.
+     * The caller yields; the main loop skips execution until a key is
+     * released and stores it in the register.
      */
     ctx->waiting_for_key = true;
     ctx->key_wait_register = reg;
-    
-    /* 
-     * In a real implementation, we'd return here and let the main loop
-     * handle the waiting. The key value gets stored when a key is released.
-     */
 }
 
 void chip8_store_bcd(Chip8Context* ctx, uint8_t x) {
-    uint8_t value = ctx->V[x];
-    
-    /* Store hundreds digit */
-    ctx->memory[ctx->I] = value / 100;
-    
-    /* Store tens digit */
-    ctx->memory[ctx->I + 1] = (value / 10) % 10;
-    
-    /* Store ones digit */
-    ctx->memory[ctx->I + 2] = value % 10;
+    chip8_store_bcd_inline(ctx, x);
 }
 
 void chip8_store_registers(Chip8Context* ctx, uint8_t x, bool increment_i) {
-    for (uint8_t i = 0; i <= x; ++i) {
-        ctx->memory[ctx->I + i] = ctx->V[i];
-    }
-    
-    if (increment_i) {
-        ctx->I += x + 1;
-    }
+    chip8_store_registers_inline(ctx, x, increment_i);
 }
 
 void chip8_load_registers(Chip8Context* ctx, uint8_t x, bool increment_i) {
-    for (uint8_t i = 0; i <= x; ++i) {
-        ctx->V[i] = ctx->memory[ctx->I + i];
-    }
-    
-    if (increment_i) {
-        ctx->I += x + 1;
-    }
+    chip8_load_registers_inline(ctx, x, increment_i);
+}
+
+uint8_t chip8_random_next(Chip8Context* ctx) {
+    return chip8_random_next_inline(ctx);
+}
+
+void chip8_random_seed_context(Chip8Context* ctx, uint32_t seed) {
+    ctx->rng_state = seed ? seed : CHIP8_RNG_DEFAULT_STATE;
 }
 
 uint8_t chip8_random_byte(void) {
-    /* Simple xorshift RNG */
-    rng_state ^= rng_state << 13;
-    rng_state ^= rng_state >> 17;
-    rng_state ^= rng_state << 5;
-    return (uint8_t)(rng_state & 0xFF);
+    Chip8Context* ctx = chip8_get_context();
+    return chip8_random_step(ctx ? &ctx->rng_state : &g_rng_fallback);
 }
 
 void chip8_random_seed(uint32_t seed) {
-    rng_state = seed;
-    if (rng_state == 0) {
-        rng_state = 0x12345678;
+    Chip8Context* ctx = chip8_get_context();
+    if (ctx) {
+        chip8_random_seed_context(ctx, seed);
     }
+    g_rng_fallback = seed ? seed : CHIP8_RNG_DEFAULT_STATE;
+}
+
+uint32_t chip8_random_get_state(void) {
+    Chip8Context* ctx = chip8_get_context();
+    return ctx ? ctx->rng_state : g_rng_fallback;
 }
 
 void chip8_tick_timers(Chip8Context* ctx) {
@@ -130,6 +121,28 @@ void chip8_tick_timers(Chip8Context* ctx) {
     }
     
     if (ctx->sound_timer > 0) {
-        ctx->sound_timer--;
+        if (--ctx->sound_timer == 0) {
+            chip8_audio_record(ctx, CHIP8_AUDIO_EVENT_TONE);
+        }
+    }
+}
+
+void chip8_set_sound_timer(Chip8Context* ctx, uint8_t value) {
+    bool was_active = ctx->sound_timer > 0;
+    ctx->sound_timer = value;
+    if (was_active != (value > 0)) {
+        chip8_audio_record(ctx, CHIP8_AUDIO_EVENT_TONE);
     }
 }
+
+void chip8_load_audio_pattern(Chip8Context* ctx) {
+    for (unsigned i = 0; i < CHIP8_AUDIO_PATTERN_SIZE; ++i) {
+        ctx->audio_pattern[i] = ctx->memory[(ctx->I + i) & 0x0FFF];
+    }
+    chip8_audio_record(ctx, CHIP8_AUDIO_EVENT_PATTERN);
+}
+
+void chip8_set_audio_pitch(Chip8Context* ctx, uint8_t x) {
+    ctx->audio_pitch = ctx->V[x];
+    chip8_audio_record(ctx, CHIP8_AUDIO_EVENT_PITCH);
+}
@@ -0,0 +1,767 @@
+/**
+ * @file interpreter.c
+ * @brief Fallback interpreter, translation cache and self-modifying code tracking
+ */
+
+#include "chip8rt/interpreter.h"
+#include "chip8rt/runtime.h"
+#include <string.h>
+
+/* ============================================================================
+ * Code Map Registration
+ * ========================================================================== */
+
+static const Chip8CodeInfo* g_code_info = NULL;
+
+/* Program image as loaded, used to tell modified code from restored code */
+static uint8_t g_pristine[CHIP8_MEMORY_SIZE];
+
+/* Stores to these addresses are reported: recompiled code plus cached blocks */
+static uint8_t g_watch_map[CHIP8_CODE_MAP_SIZE];
+
+void chip8_register_code_info(const Chip8CodeInfo* info) {
+    g_code_info = info;
+}
+
+const Chip8CodeInfo* chip8_get_code_info(void) {
+    return g_code_info;
+}
+
+static inline bool map_bit(const uint8_t* map, uint16_t addr) {
+    return (map[addr >> 3] >> (addr & 7)) & 1;
+}
+
+/* ============================================================================
+ * Self-Modifying Code Tracking
+ * ========================================================================== */
+
+static void tcache_flush(void);
+static void tcache_invalidate(uint16_t addr, uint16_t len);
+
+/* Recompiled code of the registered program, or NULL */
+static inline const uint8_t* recompiled_map(void) {
+    return g_code_info ? g_code_info->code_map : NULL;
+}
+
+void chip8_smc_reset(Chip8Context* ctx) {
+    memcpy(g_pristine, ctx->memory, sizeof(g_pristine));
+    tcache_flush();
+    ctx->watch_map = g_watch_map;
+    memset(ctx->smc_dirty, 0, sizeof(ctx->smc_dirty));
+    ctx->smc_pending = false;
+    ctx->in_interpreter = false;
+}
+
+/* Re-check one page: dirty if any recompiled byte differs from the image */
+static bool smc_update_page(Chip8Context* ctx, const uint8_t* code_map, uint16_t page) {
+    uint16_t start = page * CHIP8_SMC_PAGE_SIZE;
+    bool dirty = false;
+
+    for (uint16_t a = start; a < start + CHIP8_SMC_PAGE_SIZE; ++a) {
+        if (map_bit(code_map, a) && ctx->memory[a] != g_pristine[a]) {
+            dirty = true;
+            break;
+        }
+    }
+
+    if (dirty) {
+        ctx->smc_dirty[page >> 5] |= 1u << (page & 31);
+    } else {
+        ctx->smc_dirty[page >> 5] &= ~(1u << (page & 31));
+    }
+    return dirty;
+}
+
+void chip8_smc_record_write(Chip8Context* ctx, uint16_t addr, uint16_t len) {
+    if (len == 0) return;
+
+    /* Cached translations of the written bytes are stale either way */
+    tcache_invalidate(addr, len);
+
+    const uint8_t* code_map = recompiled_map();
+    if (!code_map) return;
+
+    uint16_t first = (addr & 0x0FFF) / CHIP8_SMC_PAGE_SIZE;
+    uint16_t last = ((addr + len - 1) & 0x0FFF) / CHIP8_SMC_PAGE_SIZE;
+
+    bool dirty = smc_update_page(ctx, code_map, first);
+    if (last != first) {
+        dirty |= smc_update_page(ctx, code_map, last);
+    }
+
+    if (dirty) {
+        ctx->smc_pending = true;
+    }
+}
+
+static bool smc_any_dirty(const Chip8Context* ctx) {
+    for (size_t i = 0; i < sizeof(ctx->smc_dirty) / sizeof(ctx->smc_dirty[0]); ++i) {
+        if (ctx->smc_dirty[i]) return true;
+    }
+    return false;
+}
+
+bool chip8_smc_block_dirty(const Chip8Context* ctx, uint16_t addr) {
+    const uint8_t* code_map = recompiled_map();
+    if (!code_map || !smc_any_dirty(ctx)) return false;
+
+    /* A block runs until the next re-entry point or the end of the code run */
+    const uint8_t* resume_map = g_code_info->resume_map;
+    uint16_t end = addr + 1;
+    while (end < CHIP8_MEMORY_SIZE && map_bit(code_map, end) &&
+           !(resume_map && map_bit(resume_map, end))) {
+        ++end;
+    }
+
+    for (uint16_t page = addr / CHIP8_SMC_PAGE_SIZE;
+         page <= (end - 1) / CHIP8_SMC_PAGE_SIZE; ++page) {
+        if (ctx->smc_dirty[page >> 5] & (1u << (page & 31))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void chip8_smc_sync(const Chip8Context* ctx, const Chip8Context* other) {
+    if (memcmp(ctx->memory, other->memory, sizeof(ctx->memory)) == 0) {
+        return;
+    }
+
+    /* Drop translations of every run of bytes the two images disagree on */
+    uint16_t addr = 0;
+    while (addr < CHIP8_MEMORY_SIZE) {
+        if (ctx->memory[addr] == other->memory[addr]) {
+            ++addr;
+            continue;
+        }
+        uint16_t start = addr;
+        while (addr < CHIP8_MEMORY_SIZE && ctx->memory[addr] != other->memory[addr]) {
+            ++addr;
+        }
+        tcache_invalidate(start, (uint16_t)(addr - start));
+    }
+}
+
+/* ============================================================================
+ * Interpreter
+ *
+ * Opcodes are pre-decoded into a handler ID plus operand fields: a 16-entry
+ * table on the first nibble resolves most opcodes directly, and the 0, 8, E
+ * and F groups go through their own sub-tables. Execution then dispatches
+ * once on the handler ID - threaded through a label table on GCC/Clang,
+ * through a switch elsewhere.
+ * ========================================================================== */
+
+#if defined(__GNUC__) || defined(__clang__)
+#define CHIP8_INTERP_THREADED 1
+#else
+#define CHIP8_INTERP_THREADED 0
+#endif
+
+/** Interpreter handler IDs */
+enum {
+    OP_NOP,
+    OP_CLS, OP_RET, OP_JP, OP_CALL,
+    OP_SE_NN, OP_SNE_NN, OP_SE_VY, OP_SNE_VY,
+    OP_LD_NN, OP_ADD_NN,
+    OP_LD_VY, OP_OR, OP_AND, OP_XOR, OP_ADD_VY, OP_SUB, OP_SHR, OP_SUBN, OP_SHL,
+    OP_LD_I, OP_JP_V0, OP_RND, OP_DRW, OP_SKP, OP_SKNP,
+    OP_LD_VX_DT, OP_LD_VX_K, OP_LD_DT, OP_LD_ST, OP_ADD_I, OP_LD_F,
+    OP_LD_B, OP_LD_I_VX, OP_LD_VX_I, OP_AUDIO, OP_PITCH,
+    OP_COUNT,
+
+    /* First-nibble entries that need a sub-table */
+    OP_GROUP_0 = OP_COUNT, OP_GROUP_5, OP_GROUP_8, OP_GROUP_9, OP_GROUP_E, OP_GROUP_F
+};
+
+/** Pre-decoded instruction */
+typedef struct Chip8InterpOp {
+    uint16_t pc;
+    uint16_t nnn;
+    uint8_t id;
+    uint8_t x;
+    uint8_t y;
+    uint8_t nn;
+} Chip8InterpOp;
+
+static const uint8_t g_ops[16] = {
+    OP_GROUP_0, OP_JP,      OP_CALL,  OP_SE_NN,
+    OP_SNE_NN,  OP_GROUP_5, OP_LD_NN, OP_ADD_NN,
+    OP_GROUP_8, OP_GROUP_9, OP_LD_I,  OP_JP_V0,
+    OP_RND,     OP_DRW,     OP_GROUP_E, OP_GROUP_F
+};
+
+static const uint8_t g_ops_8[16] = {
+    OP_LD_VY,  OP_OR,   OP_AND, OP_XOR,
+    OP_ADD_VY, OP_SUB,  OP_SHR, OP_SUBN,
+    OP_NOP,    OP_NOP,  OP_NOP, OP_NOP,
+    OP_NOP,    OP_NOP,  OP_SHL, OP_NOP
+};
+
+static const uint8_t g_ops_f[256] = {
+    [0x02] = OP_AUDIO,
+    [0x07] = OP_LD_VX_DT,
+    [0x0A] = OP_LD_VX_K,
+    [0x15] = OP_LD_DT,
+    [0x18] = OP_LD_ST,
+    [0x1E] = OP_ADD_I,
+    [0x29] = OP_LD_F,
+    [0x33] = OP_LD_B,
+    [0x3A] = OP_PITCH,
+    [0x55] = OP_LD_I_VX,
+    [0x65] = OP_LD_VX_I
+};
+
+static inline Chip8InterpOp interp_decode(uint16_t opcode, uint16_t pc) {
+    Chip8InterpOp op;
+    op.pc = pc;
+    uint8_t n = opcode & 0xF;
+    op.x = (opcode >> 8) & 0xF;
+    op.y = (opcode >> 4) & 0xF;
+    op.nn = opcode & 0xFF;
+    op.nnn = opcode & 0x0FFF;
+    op.id = g_ops[opcode >> 12];
+
+    if (op.id >= OP_COUNT) {
+        switch (op.id) {
+            case OP_GROUP_0:
+                op.id = opcode == 0x00E0 ? OP_CLS : opcode == 0x00EE ? OP_RET : OP_NOP;
+                break;
+            case OP_GROUP_5:
+                op.id = n == 0 ? OP_SE_VY : OP_NOP;
+                break;
+            case OP_GROUP_8:
+                op.id = g_ops_8[n];
+                break;
+            case OP_GROUP_9:
+                op.id = n == 0 ? OP_SNE_VY : OP_NOP;
+                break;
+            case OP_GROUP_E:
+                op.id = op.nn == 0x9E ? OP_SKP : op.nn == 0xA1 ? OP_SKNP : OP_NOP;
+                break;
+            default:
+                op.id = g_ops_f[op.nn];
+                if (op.id == OP_AUDIO && op.x != 0) op.id = OP_NOP;
+                break;
+        }
+    }
+    return op;
+}
+
+/* ============================================================================
+ * Translation Cache
+ *
+ * Code the interpreter runs is decoded once per basic block and kept here,
+ * keyed by start address. A block ends at the first jump, call, return or
+ * store, or before the next re-entry point into recompiled code, so exits
+ * only need checking between blocks. Skips stay inside a block when the
+ * skipped instruction does. Cached bytes are added to the watch
+ * map; a store into one drops every block that covers it.
+ * ========================================================================== */
+
+#define TCACHE_MAX_BLOCKS       512
+#define TCACHE_MAX_OPS          4096
+#define TCACHE_MAX_BLOCK_OPS    32
+
+typedef struct Chip8TBlock {
+    uint16_t start;     /* Address of the first instruction */
+    uint16_t end;       /* Address after the last instruction */
+    uint16_t first_op;  /* Index into g_tcache_ops */
+    uint16_t count;     /* Number of ops (0 = invalidated) */
+} Chip8TBlock;
+
+static Chip8TBlock g_tcache_blocks[TCACHE_MAX_BLOCKS];
+static Chip8InterpOp g_tcache_ops[TCACHE_MAX_OPS];
+static uint16_t g_tcache_index[CHIP8_MEMORY_SIZE];  /* Block number + 1, 0 = none */
+static uint16_t g_tcache_num_blocks = 0;
+static uint16_t g_tcache_num_ops = 0;
+
+/* Interpreter runs in progress; native code can start one inside another */
+static int g_interp_depth = 0;
+
+static void watch_range(uint16_t start, uint16_t end) {
+    /* A block at 0xFFF ends past memory; its second byte is read from 0x000 */
+    for (uint16_t a = start; a < end; ++a) {
+        uint16_t b = a & 0x0FFF;
+        g_watch_map[b >> 3] |= (uint8_t)(1u << (b & 7));
+    }
+}
+
+static void tcache_flush(void) {
+    const uint8_t* code_map = recompiled_map();
+    if (code_map) {
+        memcpy(g_watch_map, code_map, sizeof(g_watch_map));
+    } else {
+        memset(g_watch_map, 0, sizeof(g_watch_map));
+    }
+    memset(g_tcache_index, 0, sizeof(g_tcache_index));
+    g_tcache_num_blocks = 0;
+    g_tcache_num_ops = 0;
+}
+
+static void tcache_invalidate(uint16_t addr, uint16_t len) {
+    uint16_t lo = addr & 0x0FFF;
+    uint16_t hi = lo + len;
+    bool dropped = false;
+
+    for (uint16_t i = 0; i < g_tcache_num_blocks; ++i) {
+        Chip8TBlock* block = &g_tcache_blocks[i];
+        /* (A block at 0xFFF ends past memory and wraps to 0x000) */
+        if (block->count && ((block->start < hi && block->end > lo) ||
+                             lo < block->end - CHIP8_MEMORY_SIZE)) {
+            g_tcache_index[block->start] = 0;
+            block->count = 0;
+            dropped = true;
+        }
+    }
+    if (!dropped) return;
+
+    /* Rebuild the watch map from what is still cached */
+    const uint8_t* code_map = recompiled_map();
+    if (code_map) {
+        memcpy(g_watch_map, code_map, sizeof(g_watch_map));
+    } else {
+        memset(g_watch_map, 0, sizeof(g_watch_map));
+    }
+    for (uint16_t i = 0; i < g_tcache_num_blocks; ++i) {
+        if (g_tcache_blocks[i].count) {
+            watch_range(g_tcache_blocks[i].start, g_tcache_blocks[i].end);
+        }
+    }
+}
+
+static inline bool op_ends_block(uint8_t id) {
+    switch (id) {
+        case OP_RET: case OP_JP: case OP_CALL: case OP_JP_V0:
+        case OP_LD_B: case OP_LD_I_VX:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/* Decode the block starting at pc into ops; returns the number of ops */
+static uint16_t tcache_decode(Chip8Context* ctx, uint16_t pc, const uint8_t* resume_map,
+                              Chip8InterpOp* ops) {
+    uint16_t count = 0;
+    uint16_t addr = pc;
+    for (;;) {
+        Chip8InterpOp op = interp_decode(chip8_read_word(ctx, addr), addr);
+        ops[count++] = op;
+        addr += 2;
+
+        if (op_ends_block(op.id) || count == TCACHE_MAX_BLOCK_OPS ||
+            addr > CHIP8_MEMORY_SIZE - 2 || (resume_map && map_bit(resume_map, addr))) {
+            break;
+        }
+    }
+    return count;
+}
+
+/*
+ * Decode and cache a block, flushing the cache first if it is full. A run
+ * that started this one (through native code) may still be executing ops
+ * the flush would let us overwrite, so nested runs decode into their own
+ * scratch buffer instead and leave the cache as it is.
+ */
+static const Chip8InterpOp* tcache_translate(Chip8Context* ctx, uint16_t pc,
+                                             const uint8_t* resume_map,
+                                             Chip8InterpOp* scratch, uint16_t* count) {
+    if (g_tcache_num_blocks == TCACHE_MAX_BLOCKS ||
+        g_tcache_num_ops + TCACHE_MAX_BLOCK_OPS > TCACHE_MAX_OPS) {
+        if (g_interp_depth > 1) {
+            *count = tcache_decode(ctx, pc, resume_map, scratch);
+            return scratch;
+        }
+        tcache_flush();
+    }
+
+    Chip8TBlock* block = &g_tcache_blocks[g_tcache_num_blocks];
+    block->start = pc;
+    block->first_op = g_tcache_num_ops;
+    block->count = tcache_decode(ctx, pc, resume_map, &g_tcache_ops[block->first_op]);
+    block->end = pc + block->count * 2;
+
+    g_tcache_num_ops += block->count;
+    g_tcache_index[pc] = ++g_tcache_num_blocks;
+    watch_range(block->start, block->end);
+
+    *count = block->count;
+    return &g_tcache_ops[block->first_op];
+}
+
+/* Ops of the block starting at pc; scratch holds them if they could not be cached */
+static inline const Chip8InterpOp* tcache_get(Chip8Context* ctx, uint16_t pc,
+                                              const uint8_t* resume_map,
+                                              Chip8InterpOp* scratch, uint16_t* count) {
+    uint16_t index = g_tcache_index[pc];
+    if (index) {
+        const Chip8TBlock* block = &g_tcache_blocks[index - 1];
+        *count = block->count;
+        return &g_tcache_ops[block->first_op];
+    }
+    return tcache_translate(ctx, pc, resume_map, scratch, count);
+}
+
+#if CHIP8_INTERP_THREADED
+/* Labels as values are a GNU extension; __extension__ keeps -Wpedantic quiet */
+#define INTERP_DISPATCH(id)   __extension__ ({ goto *labels[id]; });
+#define INTERP_CASE(id)       L_##id:
+#else
+#define INTERP_DISPATCH(id)   switch (id)
+#define INTERP_CASE(id)       case id:
+#endif
+#define INTERP_NEXT           goto op_done
+#define INTERP_SKIP           goto op_skip
+
+/*
+ * Run a registered function from the interpreter. Returns true if it ended
+ * the frame - by yielding, or by handing off to a nested run that yielded -
+ * in which case the calling run has to stop too and leave the rest of the
+ * frame to the interpreter, which continues at resume_pc.
+ */
+static bool interp_call_native(Chip8Context* ctx, Chip8FuncPtr func) {
+    bool in_interpreter = ctx->in_interpreter;
+    ctx->in_interpreter = false;
+    func(ctx);
+    bool yielded = ctx->should_yield || ctx->in_interpreter;
+    ctx->in_interpreter = in_interpreter;
+    ctx->should_yield = false;
+    return yielded;
+}
+
+/* Put a return address under the frames a stopped native call left on the stack */
+static bool interp_insert_return(Chip8Context* ctx, uint8_t depth, uint16_t addr) {
+    if (ctx->SP >= CHIP8_STACK_SIZE) return false;
+    memmove(&ctx->stack[depth + 1], &ctx->stack[depth],
+            (size_t)(ctx->SP - depth) * sizeof(ctx->stack[0]));
+    ctx->stack[depth] = addr;
+    ctx->SP++;
+    return true;
+}
+
+static Chip8InterpExit interp_run(Chip8Context* ctx, uint16_t pc, uint8_t base_sp) {
+#if CHIP8_INTERP_THREADED
+    __extension__ static const void* const labels[OP_COUNT] = {
+        &&L_OP_NOP,
+        &&L_OP_CLS, &&L_OP_RET, &&L_OP_JP, &&L_OP_CALL,
+        &&L_OP_SE_NN, &&L_OP_SNE_NN, &&L_OP_SE_VY, &&L_OP_SNE_VY,
+        &&L_OP_LD_NN, &&L_OP_ADD_NN,
+        &&L_OP_LD_VY, &&L_OP_OR, &&L_OP_AND, &&L_OP_XOR, &&L_OP_ADD_VY,
+        &&L_OP_SUB, &&L_OP_SHR, &&L_OP_SUBN, &&L_OP_SHL,
+        &&L_OP_LD_I, &&L_OP_JP_V0, &&L_OP_RND, &&L_OP_DRW, &&L_OP_SKP, &&L_OP_SKNP,
+        &&L_OP_LD_VX_DT, &&L_OP_LD_VX_K, &&L_OP_LD_DT, &&L_OP_LD_ST, &&L_OP_ADD_I,
+        &&L_OP_LD_F, &&L_OP_LD_B, &&L_OP_LD_I_VX, &&L_OP_LD_VX_I, &&L_OP_AUDIO,
+        &&L_OP_PITCH
+    };
+#endif
+    const Chip8CodeInfo* info = g_code_info;
+    const uint8_t* resume_map = info ? info->resume_map : NULL;
+    uint32_t quirks = info ? info->quirks
+                           : (CHIP8_QUIRK_VF_RESET | CHIP8_QUIRK_LOAD_STORE_INC_I);
+    bool vf_reset = (quirks & CHIP8_QUIRK_VF_RESET) != 0;
+    bool shift_vy = (quirks & CHIP8_QUIRK_SHIFT_VY) != 0;
+    bool inc_i = (quirks & CHIP8_QUIRK_LOAD_STORE_INC_I) != 0;
+    bool trace_blocks = info && info->block_trace;
+
+    /* Only per-function builds register C entry points */
+    bool has_functions = !resume_map;
+
+    uint8_t* V = ctx->V;
+    uint16_t next;
+    uint16_t target = 0;
+    Chip8InterpOp scratch[TCACHE_MAX_BLOCK_OPS];
+
+    ctx->in_interpreter = true;
+    ctx->smc_pending = false;
+    pc &= 0x0FFF;
+
+    for (;;) {
+        uint16_t count;
+        const Chip8InterpOp* op = tcache_get(ctx, pc, resume_map, scratch, &count);
+        if (trace_blocks) {
+            CHIP8_TRACE_BLOCK(ctx, pc);
+        }
+        CHIP8_BREAKPOINT(ctx, pc);
+        const Chip8InterpOp* last = op + count - 1;
+
+    next_op:
+        pc = op->pc;
+        next = pc + 2;
+
+        INTERP_DISPATCH(op->id) {
+        INTERP_CASE(OP_NOP)
+            /* SYS and unknown opcodes are ignored */
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_CLS)
+            chip8_clear_screen(ctx);
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_RET)
+            if (ctx->SP <= base_sp) {
+                ctx->in_interpreter = false;
+                return CHIP8_INTERP_EXIT_RETURN;
+            }
+            next = ctx->stack[--ctx->SP];
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_JP)
+            if (op->nnn <= pc && --ctx->cycles_remaining <= 0) {
+                ctx->resume_pc = op->nnn;
+                return CHIP8_INTERP_EXIT_YIELD;
+            }
+            target = op->nnn;
+            goto jump;
+
+        INTERP_CASE(OP_CALL)
+            if (has_functions) {
+                Chip8FuncPtr func = chip8_lookup_function(op->nnn);
+                if (func && !chip8_smc_block_dirty(ctx, op->nnn)) {
+                    uint8_t depth = ctx->SP;
+                    if (!interp_call_native(ctx, func)) INTERP_NEXT;
+
+                    /* The interpreter finishes the function, then returns here */
+                    if (!interp_insert_return(ctx, depth, next)) {
+                        chip8_panic("Stack overflow", pc);
+                        ctx->in_interpreter = false;
+                        return CHIP8_INTERP_EXIT_RETURN;
+                    }
+                    return CHIP8_INTERP_EXIT_YIELD;
+                }
+            }
+            if (ctx->SP >= CHIP8_STACK_SIZE) {
+                chip8_panic("Stack overflow", pc);
+                ctx->in_interpreter = false;
+                return CHIP8_INTERP_EXIT_RETURN;
+            }
+            ctx->stack[ctx->SP++] = next;
+            next = op->nnn;
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_SE_NN)
+            if (V[op->x] == op->nn) INTERP_SKIP;
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_SNE_NN)
+            if (V[op->x] != op->nn) INTERP_SKIP;
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_SE_VY)
+            if (V[op->x] == V[op->y]) INTERP_SKIP;
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_SNE_VY)
+            if (V[op->x] != V[op->y]) INTERP_SKIP;
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_LD_NN)
+            V[op->x] = op->nn;
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_ADD_NN)
+            V[op->x] += op->nn;
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_LD_VY)
+            V[op->x] = V[op->y];
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_OR)
+            V[op->x] |= V[op->y];
+            if (vf_reset) V[0xF] = 0;
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_AND)
+            V[op->x] &= V[op->y];
+            if (vf_reset) V[0xF] = 0;
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_XOR)
+            V[op->x] ^= V[op->y];
+            if (vf_reset) V[0xF] = 0;
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_ADD_VY)
+            CHIP8_ADD_VX_VY(ctx, op->x, op->y);
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_SUB)
+            CHIP8_SUB_VX_VY(ctx, op->x, op->y);
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_SHR)
+            if (shift_vy) {
+                CHIP8_SHR_VX_VY(ctx, op->x, op->y);
+            } else {
+                CHIP8_SHR_VX(ctx, op->x);
+            }
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_SUBN)
+            CHIP8_SUBN_VX_VY(ctx, op->x, op->y);
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_SHL)
+            if (shift_vy) {
+                CHIP8_SHL_VX_VY(ctx, op->x, op->y);
+            } else {
+                CHIP8_SHL_VX(ctx, op->x);
+            }
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_LD_I)
+            ctx->I = op->nnn;
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_JP_V0)
+            target = (op->nnn + V[0]) & 0x0FFF;
+            goto jump;
+
+        INTERP_CASE(OP_RND)
+            V[op->x] = chip8_random_next(ctx) & op->nn;
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_DRW)
+            chip8_draw_sprite(ctx, op->x, op->y, op->nnn & 0xF);
+            --ctx->cycles_remaining;
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_SKP)
+            if (chip8_key_pressed(ctx, V[op->x])) INTERP_SKIP;
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_SKNP)
+            if (!chip8_key_pressed(ctx, V[op->x])) INTERP_SKIP;
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_LD_VX_DT)
+            V[op->x] = ctx->delay_timer;
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_LD_VX_K)
+            /* End the frame; continue after the wait once the key arrives */
+            chip8_wait_key(ctx, op->x);
+            ctx->resume_pc = next;
+            return CHIP8_INTERP_EXIT_YIELD;
+
+        INTERP_CASE(OP_LD_DT)
+            ctx->delay_timer = V[op->x];
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_LD_ST)
+            chip8_set_sound_timer(ctx, V[op->x]);
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_ADD_I)
+            ctx->I += V[op->x];
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_LD_F)
+            ctx->I = CHIP8_FONT_START + (V[op->x] & 0xF) * 5;
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_LD_B)
+            chip8_store_bcd(ctx, op->x);
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_LD_I_VX)
+            chip8_store_registers(ctx, op->x, inc_i);
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_LD_VX_I)
+            chip8_load_registers(ctx, op->x, inc_i);
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_AUDIO)
+            chip8_load_audio_pattern(ctx);
+            INTERP_NEXT;
+
+        INTERP_CASE(OP_PITCH)
+            chip8_set_audio_pitch(ctx, op->x);
+            INTERP_NEXT;
+        }
+
+    jump:
+        /*
+         * Per-function builds register a C entry point for every CALL target.
+         * Jumping to one is a tail call: run it, then return from this frame.
+         */
+        if (has_functions) {
+            Chip8FuncPtr func = chip8_lookup_function(target);
+            if (func && !chip8_smc_block_dirty(ctx, target)) {
+                if (interp_call_native(ctx, func)) {
+                    return CHIP8_INTERP_EXIT_YIELD;
+                }
+                if (ctx->SP <= base_sp) {
+                    ctx->in_interpreter = false;
+                    return CHIP8_INTERP_EXIT_RETURN;
+                }
+                target = ctx->stack[--ctx->SP];
+            }
+        }
+        next = target;
+        goto block_done;
+
+    op_skip:
+        /* The skipped instruction is usually in this block: step over its op */
+        next = pc + 4;
+        if (op + 1 < last) {
+            op += 2;
+            goto next_op;
+        }
+        goto block_done;
+
+    op_done:
+        if (op++ != last) goto next_op;
+
+    block_done:
+        pc = next & 0x0FFF;
+
+        /* Leave as soon as unmodified recompiled code can take over */
+        if (resume_map && map_bit(resume_map, pc) &&
+            !chip8_smc_block_dirty(ctx, pc)) {
+            ctx->in_interpreter = false;
+            ctx->smc_pending = false;
+            ctx->resume_pc = pc;
+            ctx->should_yield = true;
+            return CHIP8_INTERP_EXIT_RESUME;
+        }
+    }
+}
+
+#undef INTERP_DISPATCH
+#undef INTERP_CASE
+#undef INTERP_NEXT
+#undef INTERP_SKIP
+
+Chip8InterpExit chip8_interp_run(Chip8Context* ctx, uint16_t pc) {
+    /* A nested run returns once it unwinds to the frame native code started it in */
+    uint8_t base_sp = g_interp_depth > 0 ? ctx->SP : 0;
+
+    g_interp_depth++;
+    Chip8InterpExit exit = interp_run(ctx, pc, base_sp);
+    g_interp_depth--;
+    return exit;
+}
+
+/* ============================================================================
+ * Frame Execution
+ * ========================================================================== */
+
+void chip8_execute(Chip8Context* ctx, Chip8EntryPoint entry) {
+    if (ctx->in_interpreter) {
+        /* The interpreter yielded last frame; let it continue */
+        if (chip8_interp_run(ctx, ctx->resume_pc) != CHIP8_INTERP_EXIT_RESUME) {
+            return;
+        }
+    } else if (ctx->should_yield && chip8_smc_block_dirty(ctx, ctx->resume_pc)) {
+        /* The block we would resume into was overwritten */
+        ctx->should_yield = false;
+        if (chip8_interp_run(ctx, ctx->resume_pc) != CHIP8_INTERP_EXIT_RESUME) {
+            return;
+        }
+    }
+
+    entry(ctx);
+}
@@ -0,0 +1,322 @@
+/**
+ * @file lockstep.c
+ * @brief Differential execution against a reference interpreter
+ *
+ * The reference interpreter here is deliberately simple and independent of
+ * interpreter.c: one instruction per loop iteration, decoded with a switch,
+ * no caching and no hand-offs. It shares only the instruction helpers and
+ * the cycle model (one cycle per DRW and per backward jump, yielding at
+ * backward jumps) with generated code.
+ */
+
+#include "chip8rt/lockstep.h"
+#include "chip8rt/runtime.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct Chip8Lockstep {
+    /** Context the reference interpreter runs on */
+    Chip8Context ref;
+
+    /** Reference program counter (next instruction to execute) */
+    uint16_t pc;
+
+    /** Frames compared so far */
+    uint64_t frame;
+
+    /** A divergence has been reported */
+    bool diverged;
+};
+
+/* ============================================================================
+ * Reference Interpreter
+ * ========================================================================== */
+
+/* Run until the cycle budget yields or the program returns from its entry */
+static void ref_run_frame(Chip8Lockstep* ls) {
+    Chip8Context* ctx = &ls->ref;
+    const Chip8CodeInfo* info = chip8_get_code_info();
+    uint32_t quirks = info ? info->quirks
+                           : (CHIP8_QUIRK_VF_RESET | CHIP8_QUIRK_LOAD_STORE_INC_I);
+    bool inc_i = (quirks & CHIP8_QUIRK_LOAD_STORE_INC_I) != 0;
+    uint16_t pc = ls->pc;
+
+    ctx->should_yield = false;
+
+    for (;;) {
+        uint16_t opcode = chip8_read_word(ctx, pc);
+        uint8_t x = (opcode >> 8) & 0xF;
+        uint8_t y = (opcode >> 4) & 0xF;
+        uint8_t n = opcode & 0xF;
+        uint8_t nn = opcode & 0xFF;
+        uint16_t nnn = opcode & 0x0FFF;
+        uint16_t next = pc + 2;
+
+        switch (opcode >> 12) {
+            case 0x0:
+                if (opcode == 0x00E0) {
+                    chip8_clear_screen(ctx);
+                } else if (opcode == 0x00EE) {
+                    if (ctx->SP == 0) {
+                        /* Returning from the entry point restarts it next frame */
+                        ls->pc = CHIP8_PROGRAM_START;
+                        return;
+                    }
+                    next = ctx->stack[--ctx->SP];
+                }
+                break;
+            case 0x1:
+                if (nnn <= pc && --ctx->cycles_remaining <= 0) {
+                    ctx->resume_pc = nnn;
+                    ctx->should_yield = true;
+                    ls->pc = nnn;
+                    return;
+                }
+                next = nnn;
+                break;
+            case 0x2:
+                if (ctx->SP < CHIP8_STACK_SIZE) {
+                    ctx->stack[ctx->SP] = next;
+                }
+                ctx->SP++;
+                next = nnn;
+                break;
+            case 0x3: if (ctx->V[x] == nn) next += 2; break;
+            case 0x4: if (ctx->V[x] != nn) next += 2; break;
+            case 0x5: if (n == 0 && ctx->V[x] == ctx->V[y]) next += 2; break;
+            case 0x6: ctx->V[x] = nn; break;
+            case 0x7: ctx->V[x] += nn; break;
+            case 0x8:
+                switch (n) {
+                    case 0x0: ctx->V[x] = ctx->V[y]; break;
+                    case 0x1:
+                        ctx->V[x] |= ctx->V[y];
+                        if (quirks & CHIP8_QUIRK_VF_RESET) ctx->V[0xF] = 0;
+                        break;
+                    case 0x2:
+                        ctx->V[x] &= ctx->V[y];
+                        if (quirks & CHIP8_QUIRK_VF_RESET) ctx->V[0xF] = 0;
+                        break;
+                    case 0x3:
+                        ctx->V[x] ^= ctx->V[y];
+                        if (quirks & CHIP8_QUIRK_VF_RESET) ctx->V[0xF] = 0;
+                        break;
+                    case 0x4: CHIP8_ADD_VX_VY(ctx, x, y); break;
+                    case 0x5: CHIP8_SUB_VX_VY(ctx, x, y); break;
+                    case 0x6:
+                        if (quirks & CHIP8_QUIRK_SHIFT_VY) CHIP8_SHR_VX_VY(ctx, x, y);
+                        else CHIP8_SHR_VX(ctx, x);
+                        break;
+                    case 0x7: CHIP8_SUBN_VX_VY(ctx, x, y); break;
+                    case 0xE:
+                        if (quirks & CHIP8_QUIRK_SHIFT_VY) CHIP8_SHL_VX_VY(ctx, x, y);
+                        else CHIP8_SHL_VX(ctx, x);
+                        break;
+                    default: break;
+                }
+                break;
+            case 0x9: if (n == 0 && ctx->V[x] != ctx->V[y]) next += 2; break;
+            case 0xA: ctx->I = nnn; break;
+            case 0xB: next = nnn + ctx->V[0]; break;
+            case 0xC: ctx->V[x] = chip8_random_next(ctx) & nn; break;
+            case 0xD:
+                chip8_draw_sprite(ctx, x, y, n);
+                --ctx->cycles_remaining;
+                break;
+            case 0xE:
+                if (nn == 0x9E && chip8_key_pressed(ctx, ctx->V[x])) next += 2;
+                if (nn == 0xA1 && !chip8_key_pressed(ctx, ctx->V[x])) next += 2;
+                break;
+            case 0xF:
+                switch (nn) {
+                    case 0x02: if (x == 0) chip8_load_audio_pattern(ctx); break;
+                    case 0x07: ctx->V[x] = ctx->delay_timer; break;
+                    case 0x0A:
+                        chip8_wait_key(ctx, x);
+                        ctx->resume_pc = next;
+                        ctx->should_yield = true;
+                        ls->pc = next;
+                        return;
+                    case 0x15: ctx->delay_timer = ctx->V[x]; break;
+                    case 0x18: chip8_set_sound_timer(ctx, ctx->V[x]); break;
+                    case 0x1E: ctx->I += ctx->V[x]; break;
+                    case 0x29: ctx->I = CHIP8_FONT_START + (ctx->V[x] & 0xF) * 5; break;
+                    case 0x33: chip8_store_bcd(ctx, x); break;
+                    case 0x3A: chip8_set_audio_pitch(ctx, x); break;
+                    case 0x55: chip8_store_registers(ctx, x, inc_i); break;
+                    case 0x65: chip8_load_registers(ctx, x, inc_i); break;
+                    default: break;
+                }
+                break;
+        }
+
+        pc = next & 0x0FFF;
+    }
+}
+
+/* ============================================================================
+ * Comparison
+ * ========================================================================== */
+
+/* FNV-1a over memory */
+static uint32_t memory_hash(const Chip8Context* ctx) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < CHIP8_MEMORY_SIZE; ++i) {
+        hash = (hash ^ ctx->memory[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/* The fallback interpreter yields without setting should_yield */
+static bool recompiled_yielded(const Chip8Context* ctx) {
+    return ctx->should_yield || ctx->in_interpreter;
+}
+
+static void report_header(Chip8Lockstep* ls, const Chip8Context* ctx) {
+    if (ls->diverged) return;
+    ls->diverged = true;
+
+    fprintf(stderr, "LOCKSTEP DIVERGENCE at frame %llu\n", (unsigned long long)ls->frame);
+    fprintf(stderr, "  yield:   recompiled %s0x%03X, reference %s0x%03X\n",
+            recompiled_yielded(ctx) ? "" : "(returned) ", ctx->resume_pc,
+            ls->ref.should_yield ? "" : "(returned) ", ls->ref.resume_pc);
+}
+
+static void compare_u16(Chip8Lockstep* ls, const Chip8Context* ctx,
+                        const char* name, unsigned a, unsigned b) {
+    if (a != b) {
+        report_header(ls, ctx);
+        fprintf(stderr, "  %-8s recompiled 0x%02X, reference 0x%02X\n", name, a, b);
+    }
+}
+
+static void compare_state(Chip8Lockstep* ls, const Chip8Context* ctx) {
+    const Chip8Context* ref = &ls->ref;
+    char name[16];
+
+    if (recompiled_yielded(ctx) != ref->should_yield ||
+        (ref->should_yield && ctx->resume_pc != ref->resume_pc)) {
+        report_header(ls, ctx);
+    }
+
+    for (int i = 0; i < CHIP8_NUM_REGISTERS; ++i) {
+        snprintf(name, sizeof(name), "V%X:", i);
+        compare_u16(ls, ctx, name, ctx->V[i], ref->V[i]);
+    }
+    compare_u16(ls, ctx, "I:", ctx->I, ref->I);
+
+    /* Per-function builds make CALL a C call, which leaves SP and the stack alone */
+    const Chip8CodeInfo* info = chip8_get_code_info();
+    if (info && info->resume_map) {
+        compare_u16(ls, ctx, "SP:", ctx->SP, ref->SP);
+        for (int i = 0; i < ctx->SP && i < ref->SP && i < CHIP8_STACK_SIZE; ++i) {
+            snprintf(name, sizeof(name), "stack%d:", i);
+            compare_u16(ls, ctx, name, ctx->stack[i], ref->stack[i]);
+        }
+    }
+    compare_u16(ls, ctx, "DT:", ctx->delay_timer, ref->delay_timer);
+    compare_u16(ls, ctx, "ST:", ctx->sound_timer, ref->sound_timer);
+    compare_u16(ls, ctx, "pitch:", ctx->audio_pitch, ref->audio_pitch);
+    if (memcmp(ctx->audio_pattern, ref->audio_pattern, sizeof(ctx->audio_pattern)) != 0) {
+        report_header(ls, ctx);
+        fprintf(stderr, "  pattern: differs\n");
+    }
+    compare_u16(ls, ctx, "wait:", ctx->waiting_for_key, ref->waiting_for_key);
+
+    if (ctx->rng_state != ref->rng_state) {
+        report_header(ls, ctx);
+        fprintf(stderr, "  random:  different number of CXNN draws\n");
+    }
+
+    uint32_t hash = memory_hash(ctx);
+    uint32_t ref_hash = memory_hash(ref);
+    if (hash != ref_hash) {
+        report_header(ls, ctx);
+        for (uint16_t a = 0; a < CHIP8_MEMORY_SIZE; ++a) {
+            if (ctx->memory[a] != ref->memory[a]) {
+                fprintf(stderr, "  memory:  hash %08x vs %08x, first difference at 0x%03X "
+                        "(0x%02X vs 0x%02X)\n",
+                        hash, ref_hash, a, ctx->memory[a], ref->memory[a]);
+                break;
+            }
+        }
+    }
+
+    if (memcmp(ctx->display, ref->display, sizeof(ctx->display)) != 0) {
+        report_header(ls, ctx);
+        fprintf(stderr, "  display: differs\n");
+    }
+}
+
+/* ============================================================================
+ * Public Interface
+ * ========================================================================== */
+
+Chip8Lockstep* chip8_lockstep_create(const Chip8Context* ctx) {
+    Chip8Lockstep* ls = (Chip8Lockstep*)calloc(1, sizeof(Chip8Lockstep));
+    if (!ls) {
+        return NULL;
+    }
+    chip8_lockstep_reset(ls, ctx);
+    return ls;
+}
+
+void chip8_lockstep_destroy(Chip8Lockstep* ls) {
+    free(ls);
+}
+
+void chip8_lockstep_reset(Chip8Lockstep* ls, const Chip8Context* ctx) {
+    ls->ref = *ctx;
+
+    /* The reference never reports stores, records sound, stops in the debugger
+       or touches the platform */
+    ls->ref.watch_map = NULL;
+    ls->ref.audio_ring = NULL;
+    ls->ref.debugger = NULL;
+    ls->ref.smc_pending = false;
+    ls->ref.in_interpreter = false;
+    ls->ref.platform_data = NULL;
+
+    ls->pc = CHIP8_PROGRAM_START;
+}
+
+void chip8_lockstep_begin_frame(Chip8Lockstep* ls, const Chip8Context* ctx) {
+    Chip8Context* ref = &ls->ref;
+
+    memcpy(ref->keys, ctx->keys, sizeof(ref->keys));
+    memcpy(ref->keys_prev, ctx->keys_prev, sizeof(ref->keys_prev));
+    ref->last_key_released = ctx->last_key_released;
+    ref->delay_timer = ctx->delay_timer;
+    ref->sound_timer = ctx->sound_timer;
+
+    /* Same FX0A resolution as the main loop */
+    if (ref->waiting_for_key && ref->last_key_released >= 0) {
+        ref->V[ref->key_wait_register] = (uint8_t)ref->last_key_released;
+        ref->waiting_for_key = false;
+        ref->last_key_released = -1;
+    }
+
+    /* Same random numbers: the reference draws from a copy of the generator */
+    ref->rng_state = ctx->rng_state;
+}
+
+bool chip8_lockstep_end_frame(Chip8Lockstep* ls, const Chip8Context* ctx, int cycles) {
+    if (ls->diverged) {
+        return false;
+    }
+    ls->frame++;
+
+    if (!ls->ref.waiting_for_key) {
+        ls->ref.cycles_remaining = cycles;
+        ref_run_frame(ls);
+    }
+
+    compare_state(ls, ctx);
+
+    return !ls->diverged;
+}
+
+bool chip8_lockstep_diverged(const Chip8Lockstep* ls) {
+    return ls->diverged;
+}
@@ -68,9 +68,10 @@ static const char* GAMEPLAY_MENU_ITEMS[] = {
     "CPU Speed",
     "Key Repeat Delay",
     "Key Repeat Rate",
+    "Run-Ahead",
     "Back"
 };
-#define GAMEPLAY_MENU_COUNT 4
+#define GAMEPLAY_MENU_COUNT 5
 
 /* Quirks settings items */
 static const char* QUIRKS_MENU_ITEMS[] = {
@@ -260,6 +261,12 @@ static void adjust_value(Chip8MenuState* menu, int delta) {
                     if (s->gameplay.key_repeat_rate_ms > 500) s->gameplay.key_repeat_rate_ms = 500;
                     menu->settings_dirty = true;
                     break;
+                case 3: /* Run-Ahead */
+                    s->gameplay.run_ahead_frames += delta;
+                    if (s->gameplay.run_ahead_frames < 0) s->gameplay.run_ahead_frames = 0;
+                    if (s->gameplay.run_ahead_frames > 4) s->gameplay.run_ahead_frames = 4;
+                    menu->settings_dirty = true;
+                    break;
             }
             break;
             
@@ -520,6 +527,10 @@ const char* chip8_menu_get_item_value(const Chip8MenuState* menu, int index) {
                 case 2: /* Key Repeat Rate */
                     snprintf(g_value_buffer, sizeof(g_value_buffer), "%d ms", s->gameplay.key_repeat_rate_ms);
                     return g_value_buffer;
+                case 3: /* Run-Ahead */
+                    if (s->gameplay.run_ahead_frames == 0) return "Off";
+                    snprintf(g_value_buffer, sizeof(g_value_buffer), "%d frames", s->gameplay.run_ahead_frames);
+                    return g_value_buffer;
             }
             break;
             
@@ -0,0 +1,152 @@
+/**
+ * @file pacer.c
+ * @brief Fixed-timestep frame pacing with precise sleeps
+ */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L  /* clock_gettime, clock_nanosleep */
+#endif
+
+#include "chip8rt/pacer.h"
+#include "chip8rt/runtime.h"
+#include <math.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <time.h>
+#endif
+
+/* ============================================================================
+ * Host Clock
+ * ========================================================================== */
+
+uint64_t chip8_pacer_now_ns(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER count;
+    if (freq.QuadPart == 0) {
+        QueryPerformanceFrequency(&freq);
+    }
+    QueryPerformanceCounter(&count);
+    uint64_t seconds = (uint64_t)(count.QuadPart / freq.QuadPart);
+    uint64_t rest = (uint64_t)(count.QuadPart % freq.QuadPart);
+    return seconds * 1000000000ull + rest * 1000000000ull / (uint64_t)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/* Sleep until about the given time; may wake late, never meaningfully early */
+static void sleep_until_ns(uint64_t deadline) {
+#if defined(_WIN32)
+    uint64_t now = chip8_pacer_now_ns();
+    if (deadline > now) {
+        Sleep((DWORD)((deadline - now) / 1000000));
+    }
+#elif defined(__APPLE__)
+    /* No clock_nanosleep: sleep for the remaining time */
+    uint64_t now = chip8_pacer_now_ns();
+    if (deadline > now) {
+        uint64_t wait = deadline - now;
+        struct timespec ts = { (time_t)(wait / 1000000000ull), (long)(wait % 1000000000ull) };
+        while (nanosleep(&ts, &ts) == -1 && errno == EINTR) {
+        }
+    }
+#else
+    struct timespec ts = { (time_t)(deadline / 1000000000ull), (long)(deadline % 1000000000ull) };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+#endif
+}
+
+/* ============================================================================
+ * Pacing
+ * ========================================================================== */
+
+/* End of the given frame on the schedule */
+static uint64_t frame_deadline(const Chip8Pacer* pacer, uint64_t frame) {
+    return pacer->start_ns + (frame + 1) * 1000000000ull / pacer->rate_hz;
+}
+
+void chip8_pacer_init(Chip8Pacer* pacer, uint32_t rate_hz) {
+    pacer->rate_hz = rate_hz > 0 ? rate_hz : 60;
+    pacer->spin_ns = CHIP8_PACER_SPIN_DEFAULT_NS;
+    pacer->oversleep_ns = CHIP8_PACER_SPIN_DEFAULT_NS / 2;
+    pacer->stats = (Chip8PacerStats){0};
+    pacer->start_ns = chip8_pacer_now_ns();
+    pacer->frame = 0;
+}
+
+void chip8_pacer_resync(Chip8Pacer* pacer) {
+    pacer->start_ns = chip8_pacer_now_ns();
+    pacer->frame = 0;
+    pacer->stats.resyncs++;
+}
+
+bool chip8_pacer_behind(const Chip8Pacer* pacer) {
+    return chip8_pacer_now_ns() > frame_deadline(pacer, pacer->frame);
+}
+
+void chip8_pacer_wait(Chip8Pacer* pacer) {
+    uint64_t deadline = frame_deadline(pacer, pacer->frame);
+    uint64_t period = 1000000000ull / pacer->rate_hz;
+    uint64_t now = chip8_pacer_now_ns();
+    pacer->frame++;
+
+    if (now >= deadline) {
+        /* Late: run the next frame at once, unless too far behind to catch up */
+        if (now - deadline > CHIP8_PACER_MAX_CATCHUP * period) {
+            chip8_pacer_resync(pacer);
+        } else {
+            pacer->stats.late_frames++;
+        }
+        return;
+    }
+
+    /* Sleep to just before the deadline and learn how late sleeps wake */
+    if (deadline - now > pacer->spin_ns) {
+        uint64_t target = deadline - pacer->spin_ns;
+        sleep_until_ns(target);
+        uint64_t woke = chip8_pacer_now_ns();
+        uint64_t over = woke > target ? woke - target : 0;
+        pacer->oversleep_ns = pacer->oversleep_ns - pacer->oversleep_ns / 8 + over / 8;
+
+        uint64_t spin = pacer->oversleep_ns * 2;
+        if (spin < CHIP8_PACER_SPIN_MIN_NS) spin = CHIP8_PACER_SPIN_MIN_NS;
+        if (spin > CHIP8_PACER_SPIN_MAX_NS) spin = CHIP8_PACER_SPIN_MAX_NS;
+        pacer->spin_ns = spin;
+    }
+
+    /* Spin tail */
+    while ((now = chip8_pacer_now_ns()) < deadline) {
+    }
+
+    uint64_t late = now - deadline;
+    pacer->stats.frames++;
+    pacer->stats.jitter_sum_ns += (double)late;
+    pacer->stats.jitter_sum_sq_ns += (double)late * (double)late;
+    if (late > pacer->stats.jitter_max_ns) {
+        pacer->stats.jitter_max_ns = late;
+    }
+}
+
+void chip8_pacer_report(const Chip8Pacer* pacer) {
+    const Chip8PacerStats* s = &pacer->stats;
+    double mean = 0.0;
+    double stddev = 0.0;
+    if (s->frames > 0) {
+        mean = s->jitter_sum_ns / (double)s->frames;
+        double variance = s->jitter_sum_sq_ns / (double)s->frames - mean * mean;
+        stddev = variance > 0.0 ? sqrt(variance) : 0.0;
+    }
+    chip8_debug("Pacer: %llu frames at %u Hz, jitter mean %.1f us, stddev %.1f us, max %.1f us, "
+                "%llu late, %llu resyncs, spin tail %.1f us",
+                (unsigned long long)s->frames, pacer->rate_hz,
+                mean / 1000.0, stddev / 1000.0, (double)s->jitter_max_ns / 1000.0,
+                (unsigned long long)s->late_frames, (unsigned long long)s->resyncs,
+                (double)pacer->spin_ns / 1000.0);
+}
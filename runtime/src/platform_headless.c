@@ -99,8 +99,9 @@ static void headless_apply_settings(Chip8Context* ctx, void* settings) {
 }
 
 static uint64_t headless_get_time_us(void) {
-    static uint64_t ticks = 0;
-    return ticks += 16667;  /* Simulate 60 FPS (16.67ms per frame) */
+    /* Virtual time: one frame per executed frame, however often this is called */
+    Chip8Context* ctx = chip8_get_context();
+    return ctx ? chip8_context_virtual_time_us(ctx) : 0;
 }
 
 static void headless_sleep_us(uint64_t microseconds) {
@@ -161,6 +162,8 @@ void chip8_dump_display(Chip8Context* ctx) {
  * @brief Dump display as a compact hash for comparison
  * 
  * Creates a simple hash of the display buffer for quick comparison.
+ * Traces use chip8_display_crc() instead; this one stays as it was so
+ * existing --hash references keep matching.
  */
 uint32_t chip8_display_hash(Chip8Context* ctx) {
     uint32_t hash = 0;
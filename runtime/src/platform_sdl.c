@@ -4,6 +4,7 @@
  */
 
 #include "chip8rt/platform.h"
+#include "chip8rt/audio.h"
 #include "chip8rt/settings.h"
 #include "chip8rt/menu.h"
 #include "chip8rt/imgui_overlay.h"
@@ -48,6 +49,10 @@ typedef struct {
     int audio_frequency;
     Chip8Waveform audio_waveform;
     
+    /* Event-driven audio (replaces audio_playing once attached) */
+    Chip8AudioRing* audio_ring;
+    Chip8AudioRenderer audio_renderer;
+    
     /* Color theme */
     Chip8Color fg_color;
     Chip8Color bg_color;
@@ -57,6 +62,13 @@ typedef struct {
     bool crt_effect;
     float scanline_intensity;
     
+    /* Effects baked at the current scale (NULL until enabled) */
+    SDL_Texture* grid_texture;
+    SDL_Texture* scanline_texture;
+    int grid_scale;             /* Scale grid_texture was built for */
+    int scanline_scale;         /* Scale scanline_texture was built for */
+    uint8_t scanline_alpha;     /* Alpha scanline_texture was built with */
+    
     /* Key repeat rate limiting */
     uint64_t key_repeat_time[16];  /* Last time each key triggered a repeat */
     bool key_first_press[16];      /* Is this the first press? */
@@ -397,6 +409,14 @@ static void audio_callback(void* userdata, uint8_t* stream, int len) {
     const float amplitude = data->audio_volume;
     const float sample_rate = 44100.0f;
     
+    /* Sample-accurate path: replay the CPU's sound events */
+    if (data->audio_ring) {
+        Chip8AudioVoice voice = { data->audio_waveform, data->audio_frequency, amplitude };
+        chip8_audio_render(&data->audio_renderer, data->audio_ring, &voice,
+                           buffer, samples, (int)sample_rate);
+        return;
+    }
+    
     for (int i = 0; i < samples; ++i) {
         if (data->audio_playing && amplitude > 0.0f) {
             float value = 0.0f;
@@ -435,6 +455,103 @@ static void audio_callback(void* userdata, uint8_t* stream, int len) {
     }
 }
 
+/* ============================================================================
+ * Effect Overlays
+ * ========================================================================== */
+
+/* Pixel grid line color (ARGB) */
+#define GRID_COLOR  0x64282828u
+
+/*
+ * The grid and scanlines only change with scale and intensity, so they are
+ * drawn once into blended textures and each frame copies them in one call
+ * instead of issuing a line draw per row and column. Both are one pixel
+ * wider and taller than the display so the closing grid lines fit.
+ */
+static SDL_Texture* create_effect_texture(SDL_Renderer* renderer, const uint32_t* pixels,
+                                          int width, int height) {
+    SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                             SDL_TEXTUREACCESS_STATIC, width, height);
+    if (!texture) {
+        fprintf(stderr, "Warning: effect texture failed: %s\n", SDL_GetError());
+        return NULL;
+    }
+    SDL_UpdateTexture(texture, NULL, pixels, width * (int)sizeof(uint32_t));
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return texture;
+}
+
+static void destroy_effect_textures(SDLPlatformData* data) {
+    if (data->grid_texture) {
+        SDL_DestroyTexture(data->grid_texture);
+        data->grid_texture = NULL;
+    }
+    if (data->scanline_texture) {
+        SDL_DestroyTexture(data->scanline_texture);
+        data->scanline_texture = NULL;
+    }
+    data->grid_scale = 0;
+    data->scanline_scale = 0;
+}
+
+/* Rebuild whichever enabled effect no longer matches the settings */
+static void update_effect_textures(SDLPlatformData* data) {
+    int scale = data->scale;
+    int width = CHIP8_DISPLAY_WIDTH * scale + 1;
+    int height = CHIP8_DISPLAY_HEIGHT * scale + 1;
+    bool want_grid = data->pixel_grid && scale >= 2;
+    bool want_scanlines = data->crt_effect && data->scanline_intensity > 0.0f;
+    uint8_t alpha = (uint8_t)(data->scanline_intensity * 128);
+
+    if (!want_grid && data->grid_texture) {
+        SDL_DestroyTexture(data->grid_texture);
+        data->grid_texture = NULL;
+        data->grid_scale = 0;
+    }
+    if (!want_scanlines && data->scanline_texture) {
+        SDL_DestroyTexture(data->scanline_texture);
+        data->scanline_texture = NULL;
+        data->scanline_scale = 0;
+    }
+
+    bool build_grid = want_grid && data->grid_scale != scale;
+    bool build_scanlines = want_scanlines &&
+        (data->scanline_scale != scale || data->scanline_alpha != alpha);
+    if (!build_grid && !build_scanlines) return;
+
+    uint32_t* pixels = (uint32_t*)malloc((size_t)width * height * sizeof(uint32_t));
+    if (!pixels) return;
+
+    if (build_grid) {
+        if (data->grid_texture) SDL_DestroyTexture(data->grid_texture);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                bool line = (x % scale) == 0 || (y % scale) == 0;
+                pixels[y * width + x] = line ? GRID_COLOR : 0;
+            }
+        }
+        data->grid_texture = create_effect_texture(data->renderer, pixels, width, height);
+        data->grid_scale = data->grid_texture ? scale : 0;
+    }
+
+    if (build_scanlines) {
+        if (data->scanline_texture) SDL_DestroyTexture(data->scanline_texture);
+        /* Every other row; the extra bottom row stays clear */
+        uint32_t dark = (uint32_t)alpha << 24;
+        for (int y = 0; y < height; ++y) {
+            uint32_t color = (y % 2 == 0 && y < height - 1) ? dark : 0;
+            for (int x = 0; x < width; ++x) {
+                pixels[y * width + x] = color;
+            }
+        }
+        data->scanline_texture = create_effect_texture(data->renderer, pixels, width, height);
+        data->scanline_scale = data->scanline_texture ? scale : 0;
+        data->scanline_alpha = alpha;
+    }
+
+    free(pixels);
+}
+
 /* ============================================================================
  * Platform Implementation
  * ========================================================================== */
@@ -588,6 +705,7 @@ static void sdl_shutdown(Chip8Context* ctx) {
     if (data->audio_device) {
         SDL_CloseAudioDevice(data->audio_device);
     }
+    destroy_effect_textures(data);
     if (data->texture) {
         SDL_DestroyTexture(data->texture);
     }
@@ -631,39 +749,17 @@ static void sdl_render(Chip8Context* ctx) {
     SDL_RenderClear(data->renderer);
     SDL_RenderCopy(data->renderer, data->texture, NULL, NULL);
     
-    /* Draw pixel grid overlay if enabled */
-    if (data->pixel_grid && data->scale >= 2) {
-        SDL_SetRenderDrawBlendMode(data->renderer, SDL_BLENDMODE_BLEND);
-        SDL_SetRenderDrawColor(data->renderer, 40, 40, 40, 100);
-        
-        int window_width = CHIP8_DISPLAY_WIDTH * data->scale;
-        int window_height = CHIP8_DISPLAY_HEIGHT * data->scale;
-        
-        /* Draw vertical lines */
-        for (int x = 0; x <= CHIP8_DISPLAY_WIDTH; ++x) {
-            SDL_RenderDrawLine(data->renderer, x * data->scale, 0, 
-                               x * data->scale, window_height);
-        }
-        /* Draw horizontal lines */
-        for (int y = 0; y <= CHIP8_DISPLAY_HEIGHT; ++y) {
-            SDL_RenderDrawLine(data->renderer, 0, y * data->scale, 
-                               window_width, y * data->scale);
-        }
+    /* Draw the baked pixel grid and CRT scanlines (see update_effect_textures) */
+    SDL_Rect effect_rect = {
+        0, 0,
+        CHIP8_DISPLAY_WIDTH * data->scale + 1,
+        CHIP8_DISPLAY_HEIGHT * data->scale + 1
+    };
+    if (data->grid_texture) {
+        SDL_RenderCopy(data->renderer, data->grid_texture, NULL, &effect_rect);
     }
-    
-    /* Draw CRT scanline effect if enabled */
-    if (data->crt_effect && data->scanline_intensity > 0.0f) {
-        SDL_SetRenderDrawBlendMode(data->renderer, SDL_BLENDMODE_BLEND);
-        uint8_t alpha = (uint8_t)(data->scanline_intensity * 128);
-        SDL_SetRenderDrawColor(data->renderer, 0, 0, 0, alpha);
-        
-        int window_height = CHIP8_DISPLAY_HEIGHT * data->scale;
-        int window_width = CHIP8_DISPLAY_WIDTH * data->scale;
-        
-        /* Draw scanlines on every other row */
-        for (int y = 0; y < window_height; y += 2) {
-            SDL_RenderDrawLine(data->renderer, 0, y, window_width, y);
-        }
+    if (data->scanline_texture) {
+        SDL_RenderCopy(data->renderer, data->scanline_texture, NULL, &effect_rect);
     }
     
     /* Render ImGui overlay */
@@ -691,7 +787,7 @@ static void sdl_render(Chip8Context* ctx) {
         if (data->overlay_state.reset_requested) {
             data->overlay_state.reset_requested = false;
             /* Reset will be handled by runtime */
-            chip8_context_reset(ctx);
+            ctx->reset_requested = true;
         }
         
         if (data->overlay_state.back_to_menu_requested) {
@@ -718,6 +814,17 @@ static void sdl_beep_stop(Chip8Context* ctx) {
     }
 }
 
+static void sdl_audio_attach(Chip8Context* ctx, Chip8AudioRing* ring) {
+    SDLPlatformData* data = (SDLPlatformData*)ctx->platform_data;
+    if (!data || !data->audio_device) {
+        return;
+    }
+    SDL_LockAudioDevice(data->audio_device);
+    chip8_audio_renderer_init(&data->audio_renderer);
+    data->audio_ring = ring;
+    SDL_UnlockAudioDevice(data->audio_device);
+}
+
 static void sdl_poll_events(Chip8Context* ctx) {
     SDLPlatformData* data = (SDLPlatformData*)ctx->platform_data;
     if (!data) return;
@@ -921,6 +1028,12 @@ static void sdl_sleep_us(uint64_t microseconds) {
     SDL_Delay((uint32_t)(microseconds / 1000));
 }
 
+static bool sdl_wait_event(Chip8Context* ctx, uint32_t timeout_ms) {
+    (void)ctx;
+    /* A NULL event peeks: the event stays queued for the next poll */
+    return SDL_WaitEventTimeout(NULL, (int)timeout_ms) != 0;
+}
+
 /* ============================================================================
  * Menu Input Handling
  * ========================================================================== */
@@ -1319,6 +1432,7 @@ static void sdl_apply_settings(Chip8Context* ctx, void* settings_ptr) {
     data->pixel_grid = settings->graphics.pixel_grid;
     data->crt_effect = settings->graphics.crt_effect;
     data->scanline_intensity = settings->graphics.scanline_intensity;
+    update_effect_textures(data);
     
     /* Apply input settings */
     memcpy(data->key_bindings, settings->input.bindings, sizeof(data->key_bindings));
@@ -1348,6 +1462,7 @@ static Chip8Platform sdl_platform = {
     .render         = sdl_render,
     .beep_start     = sdl_beep_start,
     .beep_stop      = sdl_beep_stop,
+    .audio_attach   = sdl_audio_attach,
     .poll_events    = sdl_poll_events,
     .poll_menu_events = sdl_poll_menu_events,
     .should_quit    = sdl_should_quit,
@@ -1355,6 +1470,8 @@ static Chip8Platform sdl_platform = {
     .apply_settings = sdl_apply_settings,
     .get_time_us    = sdl_get_time_us,
     .sleep_us       = sdl_sleep_us,
+    .realtime       = true,
+    .wait_event     = sdl_wait_event,
 };
 
 Chip8Platform* chip8_platform_sdl2(void) {
@@ -39,6 +39,12 @@ static bool g_should_quit = false;
 static bool g_launch_selected = false;
 static float g_animation_time = 0.0f;
 
+/* Title glow and selection pulse keep animating this long after input */
+#define ROM_SELECTOR_ANIMATION_US 5000000
+
+/* Frame length while drawing */
+#define ROM_SELECTOR_FRAME_US 16667
+
 /* ============================================================================
  * Custom Styling
  * ========================================================================== */
@@ -283,12 +289,20 @@ extern "C" int chip8_run_with_menu(const RomEntry* catalog, size_t count) {
     g_selected_rom = 0;  /* Start with first ROM selected */
     g_should_quit = false;
     
+    /* Animate while the user is around, then block on input */
+    Chip8IdleScheduler idle;
+    chip8_idle_init(&idle, CHIP8_IDLE_TIMEOUT_MS);
+    chip8_idle_animate(&idle, platform->get_time_us(), ROM_SELECTOR_ANIMATION_US);
+    
     /* ROM selection loop */
     while (!g_should_quit) {
+        uint64_t frame_start = platform->get_time_us();
+        
         /* Handle SDL events */
         SDL_Event event;
         while (SDL_PollEvent(&event)) {
             ImGui_ImplSDL2_ProcessEvent(&event);
+            chip8_idle_animate(&idle, frame_start, ROM_SELECTOR_ANIMATION_US);
             
             if (event.type == SDL_QUIT) {
                 g_should_quit = true;
@@ -318,6 +332,12 @@ extern "C" int chip8_run_with_menu(const RomEntry* catalog, size_t count) {
         
         if (g_should_quit) break;
         
+        /* Nothing changed since the last frame: keep the window as it is */
+        if (!chip8_idle_needs_draw(&idle, frame_start) && !g_launch_selected) {
+            chip8_idle_wait(&idle, &menu_ctx, frame_start, ROM_SELECTOR_FRAME_US);
+            continue;
+        }
+        
         /* Start ImGui frame */
         ImGui_ImplSDLRenderer2_NewFrame();
         ImGui_ImplSDL2_NewFrame();
@@ -383,6 +403,7 @@ extern "C" int chip8_run_with_menu(const RomEntry* catalog, size_t count) {
                 }
                 
                 g_return_to_menu = false;
+                chip8_idle_animate(&idle, platform->get_time_us(), ROM_SELECTOR_ANIMATION_US);
                 continue;
             } else {
                 /* User quit from ROM */
@@ -390,10 +411,12 @@ extern "C" int chip8_run_with_menu(const RomEntry* catalog, size_t count) {
             }
         }
         
-        /* Frame limiting */
-        SDL_Delay(16);  /* ~60 FPS */
+        /* Frame limiting, or block on input once the animation has stopped */
+        chip8_idle_wait(&idle, &menu_ctx, frame_start, ROM_SELECTOR_FRAME_US);
     }
     
+    chip8_idle_report(&idle, "Launcher");
+    
     /* Cleanup (platform->shutdown handles ImGui cleanup) */
     platform->shutdown(&menu_ctx);
     
@@ -55,6 +55,7 @@ Chip8FuncPtr chip8_lookup_function(uint16_t address) {
 
 void chip8_clear_function_table(void) {
     memset(g_func_table, 0, sizeof(g_func_table));
+    chip8_register_code_info(NULL);
 }
 
 /* ============================================================================
@@ -86,10 +87,70 @@ void chip8_debug(const char* format, ...) {
     va_end(args);
 }
 
+/* ============================================================================
+ * Run-Ahead
+ *
+ * Games read input one frame and show its effect on the next, so what is on
+ * screen lags the keys by a frame or two. With run-ahead the real context
+ * advances one frame as usual, then a copy of it runs N more frames with
+ * the same keys held and its display is the one shown. The copy is thrown
+ * away every frame: only the real context's state ever carries forward.
+ * ========================================================================== */
+
+/* Run a copy of ctx the given number of frames ahead */
+static void run_ahead(Chip8Context* shadow, const Chip8Context* ctx, Chip8EntryPoint entry,
+                      int frames, int cycles_per_frame) {
+    memcpy(shadow, ctx, sizeof(*shadow));
+    shadow->audio_ring = NULL;  /* Its sound is never heard */
+    shadow->debugger = NULL;    /* Nor does it stop at breakpoints */
+    
+    for (int i = 0; i < frames && shadow->running; ++i) {
+        if (shadow->waiting_for_key && shadow->last_key_released >= 0) {
+            shadow->V[shadow->key_wait_register] = (uint8_t)shadow->last_key_released;
+            shadow->waiting_for_key = false;
+            shadow->last_key_released = -1;
+        }
+        if (!shadow->waiting_for_key) {
+            shadow->cycles_remaining = cycles_per_frame;
+            chip8_execute(shadow, entry);
+        }
+        chip8_tick_timers(shadow);
+    }
+    
+    /* Blocks translated from the copy's memory are not ctx's code */
+    chip8_smc_sync(ctx, shadow);
+}
+
+/* Render the copy's display; the overlay's actions still apply to ctx */
+static void render_ahead(Chip8Context* ctx, const Chip8Context* shadow) {
+    uint8_t display[CHIP8_DISPLAY_SIZE];
+    
+    memcpy(display, ctx->display, sizeof(display));
+    memcpy(ctx->display, shadow->display, sizeof(display));
+    g_platform->render(ctx);
+    
+    /* A reset from the overlay only sets ctx->reset_requested; the game restarts after this */
+    memcpy(ctx->display, display, sizeof(display));
+}
+
 /* ============================================================================
  * Main Loop
  * ========================================================================== */
 
+/* Restart the program from a freshly loaded ROM */
+static void reset_game(Chip8Context* ctx, const uint8_t* rom_data, size_t rom_size,
+                       Chip8Lockstep* lockstep) {
+    chip8_context_reset(ctx);
+    if (rom_data && rom_size > 0) {
+        chip8_context_load_program(ctx, rom_data, rom_size);
+    }
+    chip8_smc_reset(ctx);
+    if (lockstep) {
+        chip8_lockstep_reset(lockstep, ctx);
+    }
+    chip8_debug("Game reset");
+}
+
 int chip8_run(Chip8EntryPoint entry_point, const Chip8RunConfig* config) {
     if (!g_platform) {
         fprintf(stderr, "Error: No platform registered\n");
@@ -125,6 +186,23 @@ int chip8_run(Chip8EntryPoint entry_point, const Chip8RunConfig* config) {
             return 1;
         }
     }
+    chip8_smc_reset(ctx);
+    
+#if CHIP8_DEBUGGER
+    ctx->debugger = chip8_debugger_get();
+#endif
+    
+    /* Reference interpreter for differential testing */
+    Chip8Lockstep* lockstep = NULL;
+    if (config->lockstep) {
+        lockstep = chip8_lockstep_create(ctx);
+        if (!lockstep) {
+            fprintf(stderr, "Error: Failed to create lockstep checker\n");
+            chip8_context_destroy(ctx);
+            return 1;
+        }
+        chip8_debug("Lockstep mode enabled");
+    }
     
     /* Initialize settings - try to load ROM-specific settings first, then global */
     Chip8Settings settings = chip8_settings_default();
@@ -156,8 +234,9 @@ int chip8_run(Chip8EntryPoint entry_point, const Chip8RunConfig* config) {
     Chip8MenuState menu;
     chip8_menu_init(&menu, &settings);
     
-    /* Seed RNG */
-    chip8_random_seed((uint32_t)time(NULL));
+    /* Seed RNG (fixed when tracing so replays are reproducible) */
+    chip8_random_seed_context(ctx, config->trace_file ? CHIP8_TRACE_RANDOM_SEED
+                                                      : (uint32_t)time(NULL));
     
     /* Initialize platform */
     if (!g_platform->init(ctx, config->title, config->scale)) {
@@ -171,6 +250,25 @@ int chip8_run(Chip8EntryPoint entry_point, const Chip8RunConfig* config) {
         chip8_headless_set_max_frames(ctx, config->max_frames);
     }
     
+    /* Sample-accurate sound for platforms that render from events */
+    Chip8AudioRing* audio_ring = NULL;
+    if (g_platform->audio_attach) {
+        audio_ring = chip8_audio_ring_create();
+        if (audio_ring) {
+            ctx->audio_ring = audio_ring;
+            g_platform->audio_attach(ctx, audio_ring);
+        }
+    }
+    
+    /* Per-frame display fingerprints for regression checks */
+    Chip8Trace* trace = NULL;
+    if (config->trace_file) {
+        trace = chip8_trace_open(config->trace_file);
+        if (!trace) {
+            fprintf(stderr, "Warning: Could not create trace file %s\n", config->trace_file);
+        }
+    }
+    
     /* Apply initial settings */
     if (g_platform->apply_settings) {
         g_platform->apply_settings(ctx, &settings);
@@ -183,7 +281,21 @@ int chip8_run(Chip8EntryPoint entry_point, const Chip8RunConfig* config) {
     
     uint64_t last_timer_tick = g_platform->get_time_us();
     
+    /* Real-time platforms run one frame and one timer tick per deadline */
+    bool paced = g_platform->realtime;
+    bool pacer_stale = false;  /* Frames were not running (menu, key wait) */
+    Chip8Pacer pacer;
+    chip8_pacer_init(&pacer, CHIP8_TIMER_FREQ_HZ);
+    
     bool was_beeping = false;
+    unsigned long long idle_frames = 0;
+    
+    /* Copy that runs ahead when run_ahead_frames is set (created on first use) */
+    Chip8Context* shadow = NULL;
+    
+    /* Blocks on input while paused or waiting for a key */
+    Chip8IdleScheduler idle;
+    chip8_idle_init(&idle, CHIP8_IDLE_TIMEOUT_MS);
     bool pause_key_released = true;  /* For edge detection on ESC */
     
     /* Save ROM data pointer for reset */
@@ -203,6 +315,7 @@ int chip8_run(Chip8EntryPoint entry_point, const Chip8RunConfig* config) {
             int nav = g_platform->poll_menu_events ? g_platform->poll_menu_events(ctx) : 0;
             if (nav == CHIP8_NAV_BACK && pause_key_released) {
                 chip8_menu_open(&menu);
+                chip8_idle_invalidate(&idle);
                 pause_key_released = false;
                 continue;
             }
@@ -213,6 +326,7 @@ int chip8_run(Chip8EntryPoint entry_point, const Chip8RunConfig* config) {
             
             if (nav != CHIP8_NAV_NONE) {
                 chip8_menu_navigate(&menu, nav);
+                chip8_idle_invalidate(&idle);
                 
                 /* Apply settings if changed */
                 if (menu.settings_dirty && g_platform->apply_settings) {
@@ -239,27 +353,33 @@ int chip8_run(Chip8EntryPoint entry_point, const Chip8RunConfig* config) {
             /* Check for reset request */
             if (menu.reset_requested) {
                 menu.reset_requested = false;
-                chip8_context_reset(ctx);
-                if (rom_data && rom_size > 0) {
-                    chip8_context_load_program(ctx, rom_data, rom_size);
-                }
-                chip8_debug("Game reset");
+                reset_game(ctx, rom_data, rom_size, lockstep);
             }
             
-            /* Render game (frozen) then menu overlay */
-            g_platform->render(ctx);
-            if (g_platform->render_menu) {
-                g_platform->render_menu(ctx, &menu);
+            /* Render game (frozen) then menu overlay, only when something changed */
+            if (chip8_idle_needs_draw(&idle, g_platform->get_time_us())) {
+                g_platform->render(ctx);
+                if (g_platform->render_menu) {
+                    g_platform->render_menu(ctx, &menu);
+                }
             }
             
-            /* Frame pacing */
-            uint64_t frame_time = g_platform->get_time_us() - frame_start;
-            if (frame_time < timer_period_us) {
-                g_platform->sleep_us(timer_period_us - frame_time);
-            }
+            /* Block on input until the menu changes */
+            chip8_idle_wait(&idle, ctx, frame_start, timer_period_us);
+            pacer_stale = true;
             continue;
         }
         
+        /* Don't catch up on the time spent paused */
+        if (pacer_stale) {
+            chip8_pacer_resync(&pacer);
+            pacer_stale = false;
+        }
+        
+        if (lockstep) {
+            chip8_lockstep_begin_frame(lockstep, ctx);
+        }
+        
         /* Handle key wait (FX0A) */
         if (ctx->waiting_for_key) {
             if (ctx->last_key_released >= 0) {
@@ -269,20 +389,39 @@ int chip8_run(Chip8EntryPoint entry_point, const Chip8RunConfig* config) {
             }
         }
         
+        /* Run one "frame" worth of instructions */
+        int cycles_per_frame = settings.gameplay.cpu_freq_hz / CHIP8_TIMER_FREQ_HZ;
+        chip8_audio_begin_frame(audio_ring, cycles_per_frame);
+        
         /* Execute instructions if not waiting */
         if (!ctx->waiting_for_key) {
-            /* Run one "frame" worth of instructions */
-            int cycles_per_frame = settings.gameplay.cpu_freq_hz / CHIP8_TIMER_FREQ_HZ;
             ctx->cycles_remaining = cycles_per_frame;
+            ctx->idle = false;
             
             /* Call entry point - it will yield back after cycles_remaining instructions */
-            entry_point(ctx);
+            chip8_execute(ctx, entry_point);
             ctx->instruction_count += (cycles_per_frame - ctx->cycles_remaining);
+            
+            /* An idle loop ended the frame early; pacing sleeps the rest */
+            if (ctx->idle) {
+                idle_frames++;
+            }
+            
+            if (ctx->reset_requested) {
+                /* Reset from the overlay while stopped: the frame was cut short */
+                reset_game(ctx, rom_data, rom_size, lockstep);
+            } else if (lockstep && !chip8_lockstep_end_frame(lockstep, ctx, cycles_per_frame)) {
+                /* Stop at the first divergence from the reference */
+                ctx->running = false;
+            }
         }
         
-        /* Timer tick (60Hz) */
+        /* One frame of virtual time has passed */
+        ctx->virtual_frames++;
+        
+        /* Timer tick (60Hz): every paced frame, or once a period has passed */
         uint64_t now = g_platform->get_time_us();
-        if (now - last_timer_tick >= timer_period_us) {
+        if (paced || now - last_timer_tick >= timer_period_us) {
             chip8_tick_timers(ctx);
             last_timer_tick = now;
             ctx->frame_count++;
@@ -296,20 +435,61 @@ int chip8_run(Chip8EntryPoint entry_point, const Chip8RunConfig* config) {
             }
             was_beeping = is_beeping;
         }
+        chip8_audio_end_frame(audio_ring);
+        
+        if (trace) {
+            chip8_trace_frame(trace, ctx);
+        }
+        
+        /* Render every frame for ImGui overlay responsiveness, unless catching up */
+        if (!paced || !chip8_pacer_behind(&pacer)) {
+            int ahead = settings.gameplay.run_ahead_frames;
+            if (ahead > 0 && !shadow) {
+                shadow = chip8_context_create();
+            }
+            if (ahead > 0 && shadow && ctx->running) {
+                run_ahead(shadow, ctx, entry_point, ahead, cycles_per_frame);
+                render_ahead(ctx, shadow);
+            } else {
+                g_platform->render(ctx);
+            }
+            ctx->display_dirty = false;
+        }
         
-        /* Always render every frame for ImGui overlay responsiveness */
-        g_platform->render(ctx);
-        ctx->display_dirty = false;
+        /* Reset from the debug overlay, now that the frame is drawn */
+        if (ctx->reset_requested) {
+            reset_game(ctx, rom_data, rom_size, lockstep);
+        }
+        
+        /*
+         * Park on input during a key wait: with both timers stopped nothing
+         * changes until a key is released, so there is no frame to run
+         */
+        if (ctx->waiting_for_key && ctx->last_key_released < 0 &&
+            ctx->delay_timer == 0 && ctx->sound_timer == 0) {
+            (void)chip8_idle_needs_draw(&idle, frame_start);  /* Drawn above */
+            chip8_idle_wait(&idle, ctx, frame_start, timer_period_us);
+            pacer_stale = true;
+            continue;
+        }
         
         /* Frame pacing - target 60fps */
-        uint64_t frame_time = g_platform->get_time_us() - frame_start;
-        if (frame_time < timer_period_us) {
-            g_platform->sleep_us(timer_period_us - frame_time);
+        if (paced) {
+            chip8_pacer_wait(&pacer);
+        } else {
+            uint64_t frame_time = g_platform->get_time_us() - frame_start;
+            if (frame_time < timer_period_us) {
+                g_platform->sleep_us(timer_period_us - frame_time);
+            }
         }
     }
     
-    chip8_debug("Shutting down after %llu frames, %llu instructions",
-                ctx->frame_count, ctx->instruction_count);
+    chip8_debug("Shutting down after %llu frames (%llu idle), %llu instructions",
+                ctx->frame_count, idle_frames, ctx->instruction_count);
+    chip8_idle_report(&idle, "Game");
+    if (paced) {
+        chip8_pacer_report(&pacer);
+    }
     
     /* Save settings before shutdown */
     if (settings_path) {
@@ -320,12 +500,20 @@ int chip8_run(Chip8EntryPoint entry_point, const Chip8RunConfig* config) {
         }
     }
     
+    int status = (lockstep && chip8_lockstep_diverged(lockstep)) ? 1 : 0;
+    if (!chip8_trace_close(trace)) {
+        fprintf(stderr, "Warning: Failed to write trace file %s\n", config->trace_file);
+    }
+    
     /* Cleanup */
     g_platform->beep_stop(ctx);
     g_platform->shutdown(ctx);
+    chip8_audio_ring_destroy(audio_ring);
+    chip8_lockstep_destroy(lockstep);
+    chip8_context_destroy(shadow);
     chip8_context_destroy(ctx);
     
-    return 0;
+    return status;
 }
 
 int chip8_run_simple(Chip8EntryPoint entry_point, const char* title) {
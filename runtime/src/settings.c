@@ -165,6 +165,7 @@ Chip8Settings chip8_settings_default(void) {
             .cpu_freq_hz = 700,
             .key_repeat_delay_ms = 200,
             .key_repeat_rate_ms = 100,
+            .run_ahead_frames = 0,
             .quirks = {
                 .vf_reset = false,
                 .shift_uses_vy = false,
@@ -394,6 +395,8 @@ bool chip8_settings_load(Chip8Settings* settings, const char* path) {
                 settings->gameplay.key_repeat_delay_ms = parse_int(value, 100, 1000, 200);
             } else if (strcmp(key, "key_repeat_rate_ms") == 0) {
                 settings->gameplay.key_repeat_rate_ms = parse_int(value, 50, 500, 100);
+            } else if (strcmp(key, "run_ahead_frames") == 0) {
+                settings->gameplay.run_ahead_frames = parse_int(value, 0, 4, 0);
             }
         } else if (strcmp(section, "quirks") == 0) {
             if (strcmp(key, "vf_reset") == 0) {
@@ -495,6 +498,7 @@ bool chip8_settings_save(const Chip8Settings* settings, const char* path) {
     fprintf(f, "cpu_freq_hz = %d\n", settings->gameplay.cpu_freq_hz);
     fprintf(f, "key_repeat_delay_ms = %d\n", settings->gameplay.key_repeat_delay_ms);
     fprintf(f, "key_repeat_rate_ms = %d\n", settings->gameplay.key_repeat_rate_ms);
+    fprintf(f, "run_ahead_frames = %d\n", settings->gameplay.run_ahead_frames);
     fprintf(f, "\n");
     
     /* Quirks */
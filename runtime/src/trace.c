@@ -0,0 +1,216 @@
+/**
+ * @file trace.c
+ * @brief Display fingerprints and per-frame trace files
+ */
+
+#include "chip8rt/trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE4_2__)
+    #define CHIP8_CRC_X86 1
+    #define CHIP8_CRC_TARGET
+    #include <nmmintrin.h>
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    /* Compiled for baseline x86; pick the SSE4.2 path at runtime */
+    #define CHIP8_CRC_X86 1
+    #define CHIP8_CRC_DISPATCH 1
+    #define CHIP8_CRC_TARGET __attribute__((target("sse4.2")))
+    #include <nmmintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+    #define CHIP8_CRC_ARM 1
+    #include <arm_acle.h>
+#endif
+
+#if defined(CHIP8_CRC_DISPATCH) || !(defined(CHIP8_CRC_X86) || defined(CHIP8_CRC_ARM))
+    #define CHIP8_CRC_TABLE 1
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define CHIP8_PACK_SSE2 1
+    #include <emmintrin.h>
+#endif
+
+/* ============================================================================
+ * CRC32C
+ * ========================================================================== */
+
+#if defined(CHIP8_CRC_TABLE)
+
+/* Reflected Castagnoli polynomial */
+#define CRC32C_POLY 0x82F63B78u
+
+static uint32_t g_crc_table[256];
+static bool g_crc_table_ready = false;
+
+static void crc_table_init(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ ((crc & 1) ? CRC32C_POLY : 0);
+        }
+        g_crc_table[i] = crc;
+    }
+    g_crc_table_ready = true;
+}
+
+static uint32_t crc32c_table(uint32_t crc, const uint8_t* p, size_t len) {
+    if (!g_crc_table_ready) {
+        crc_table_init();
+    }
+    while (len--) {
+        crc = g_crc_table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#endif /* CHIP8_CRC_TABLE */
+
+#if defined(CHIP8_CRC_X86)
+CHIP8_CRC_TARGET
+static uint32_t crc32c_hw(uint32_t crc, const uint8_t* p, size_t len) {
+#if defined(__x86_64__) || defined(_M_X64)
+    uint64_t crc64 = crc;
+    for (; len >= 8; p += 8, len -= 8) {
+        uint64_t word;
+        memcpy(&word, p, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+    }
+    crc = (uint32_t)crc64;
+#endif
+    for (; len >= 4; p += 4, len -= 4) {
+        uint32_t word;
+        memcpy(&word, p, sizeof(word));
+        crc = _mm_crc32_u32(crc, word);
+    }
+    while (len--) {
+        crc = _mm_crc32_u8(crc, *p++);
+    }
+    return crc;
+}
+#elif defined(CHIP8_CRC_ARM)
+static uint32_t crc32c_hw(uint32_t crc, const uint8_t* p, size_t len) {
+    for (; len >= 8; p += 8, len -= 8) {
+        uint64_t word;
+        memcpy(&word, p, sizeof(word));
+        crc = __crc32cd(crc, word);
+    }
+    while (len--) {
+        crc = __crc32cb(crc, *p++);
+    }
+    return crc;
+}
+#endif
+
+uint32_t chip8_crc32c(uint32_t crc, const void* data, size_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    crc = ~crc;
+
+#if defined(CHIP8_CRC_DISPATCH)
+    static int has_sse42 = -1;
+    if (has_sse42 < 0) {
+        __builtin_cpu_init();
+        has_sse42 = __builtin_cpu_supports("sse4.2") ? 1 : 0;
+    }
+    crc = has_sse42 ? crc32c_hw(crc, p, len) : crc32c_table(crc, p, len);
+#elif defined(CHIP8_CRC_X86) || defined(CHIP8_CRC_ARM)
+    crc = crc32c_hw(crc, p, len);
+#else
+    crc = crc32c_table(crc, p, len);
+#endif
+
+    return ~crc;
+}
+
+/* ============================================================================
+ * Display Fingerprint
+ * ========================================================================== */
+
+void chip8_display_pack(const Chip8Context* ctx, uint8_t* out) {
+#if defined(CHIP8_PACK_SSE2)
+    /* 16 pixels -> 16 bits per step; pixel i lands in bit i (LSB first) */
+    const __m128i zero = _mm_setzero_si128();
+    for (int i = 0; i < CHIP8_DISPLAY_SIZE; i += 16) {
+        __m128i px = _mm_loadu_si128((const __m128i*)&ctx->display[i]);
+        unsigned bits = ~(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(px, zero)) & 0xFFFFu;
+        out[i / 8] = (uint8_t)bits;
+        out[i / 8 + 1] = (uint8_t)(bits >> 8);
+    }
+#else
+    for (int i = 0; i < CHIP8_DISPLAY_SIZE; i += 8) {
+        uint8_t bits = 0;
+        for (int b = 0; b < 8; b++) {
+            bits |= (uint8_t)((ctx->display[i + b] != 0) << b);
+        }
+        out[i / 8] = bits;
+    }
+#endif
+}
+
+uint32_t chip8_display_crc(const Chip8Context* ctx) {
+    uint8_t packed[CHIP8_PACKED_DISPLAY_SIZE];
+    chip8_display_pack(ctx, packed);
+    return chip8_crc32c(0, packed, sizeof(packed));
+}
+
+/* ============================================================================
+ * Trace Files
+ * ========================================================================== */
+
+struct Chip8Trace {
+    FILE* file;
+    bool failed;
+};
+
+static void put_le16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+Chip8Trace* chip8_trace_open(const char* path) {
+    FILE* f = fopen(path, "wb");
+    if (!f) {
+        return NULL;
+    }
+
+    Chip8Trace* trace = (Chip8Trace*)calloc(1, sizeof(Chip8Trace));
+    if (!trace) {
+        fclose(f);
+        return NULL;
+    }
+    trace->file = f;
+
+    uint8_t header[CHIP8_TRACE_HEADER_SIZE] = { 'C', '8', 'T', 'R' };
+    put_le16(&header[4], CHIP8_TRACE_VERSION);
+    put_le16(&header[6], CHIP8_DISPLAY_WIDTH);
+    put_le16(&header[8], CHIP8_DISPLAY_HEIGHT);
+    put_le16(&header[10], 0);
+    if (fwrite(header, sizeof(header), 1, f) != 1) {
+        trace->failed = true;
+    }
+
+    return trace;
+}
+
+void chip8_trace_frame(Chip8Trace* trace, const Chip8Context* ctx) {
+    uint32_t crc = chip8_display_crc(ctx);
+    uint8_t bytes[4] = {
+        (uint8_t)crc, (uint8_t)(crc >> 8), (uint8_t)(crc >> 16), (uint8_t)(crc >> 24)
+    };
+    if (fwrite(bytes, sizeof(bytes), 1, trace->file) != 1) {
+        trace->failed = true;
+    }
+}
+
+bool chip8_trace_close(Chip8Trace* trace) {
+    if (!trace) {
+        return true;
+    }
+    bool ok = !trace->failed;
+    if (fclose(trace->file) != 0) {
+        ok = false;
+    }
+    free(trace);
+    return ok;
+}
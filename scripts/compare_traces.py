@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""
+Compare two per-frame display traces written with --trace.
+
+Each trace holds one CRC32C display fingerprint per frame (see
+runtime/include/chip8rt/trace.h). The traces match when every frame of the
+shorter one matches and both have the same length.
+
+Usage:
+    ./scripts/compare_traces.py expected.trace actual.trace [--max-report N]
+
+Exit status is 0 when the traces match, 1 when they differ and 2 when a
+file cannot be read.
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = b"C8TR"
+VERSION = 1
+HEADER = struct.Struct("<4sHHHH")
+
+
+def read_trace(path: str):
+    """Return (width, height, [crc, ...]) for a trace file."""
+    with open(path, "rb") as f:
+        data = f.read()
+
+    if len(data) < HEADER.size:
+        raise ValueError(f"{path}: too short for a trace header")
+
+    magic, version, width, height, _ = HEADER.unpack_from(data)
+    if magic != MAGIC:
+        raise ValueError(f"{path}: not a CHIP-8 trace file")
+    if version != VERSION:
+        raise ValueError(f"{path}: unsupported trace version {version}")
+
+    body = data[HEADER.size:]
+    if len(body) % 4:
+        print(f"Warning: {path} ends with a partial frame", file=sys.stderr)
+    count = len(body) // 4
+    frames = list(struct.unpack_from(f"<{count}I", body))
+    return width, height, frames
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Diff two CHIP-8 display traces frame by frame")
+    parser.add_argument("expected", help="Golden trace")
+    parser.add_argument("actual", help="Trace to check")
+    parser.add_argument("--max-report", type=int, default=10,
+                        help="Mismatching frames to list (default: 10)")
+    args = parser.parse_args()
+
+    try:
+        exp_w, exp_h, expected = read_trace(args.expected)
+        act_w, act_h, actual = read_trace(args.actual)
+    except (OSError, ValueError) as e:
+        print(f"Error: {e}", file=sys.stderr)
+        return 2
+
+    if (exp_w, exp_h) != (act_w, act_h):
+        print(f"Display size differs: {exp_w}x{exp_h} vs {act_w}x{act_h}")
+        return 1
+
+    common = min(len(expected), len(actual))
+    mismatches = [i for i in range(common) if expected[i] != actual[i]]
+
+    for i in mismatches[:args.max_report]:
+        print(f"frame {i}: expected {expected[i]:08x}, got {actual[i]:08x}")
+    if len(mismatches) > args.max_report:
+        print(f"... {len(mismatches) - args.max_report} more")
+
+    if len(expected) != len(actual):
+        print(f"Frame count differs: {len(expected)} vs {len(actual)}")
+
+    if mismatches or len(expected) != len(actual):
+        first = mismatches[0] if mismatches else common
+        print(f"TRACE_MATCH: FAIL ({len(mismatches)} of {common} frames differ, first at frame {first})")
+        return 1
+
+    print(f"TRACE_MATCH: PASS ({common} frames)")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
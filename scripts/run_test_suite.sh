@@ -14,10 +14,11 @@
 #   8. Scrolling - SUPER-CHIP scrolling (not applicable to base CHIP-8)
 #
 # Usage:
-#   ./scripts/run_test_suite.sh [--verify] [--run] [--test N]
+#   ./scripts/run_test_suite.sh [--verify] [--lockstep] [--run] [--test N]
 #
 # Options:
 #   --verify    Run headless and compare against reference output (CI mode)
+#   --lockstep  With --verify, also check every frame against the reference interpreter
 #   --run       Run interactively with display (requires SDL2)
 #   --test N    Only run test N (1-8)
 #   --help      Show this help
@@ -41,6 +42,7 @@ NC='\033[0m' # No Color
 
 RUN_TESTS=false
 HEADLESS_VERIFY=false
+LOCKSTEP_ARGS=()
 SINGLE_TEST=""
 
 # Parse arguments
@@ -54,12 +56,16 @@ while [[ $# -gt 0 ]]; do
             HEADLESS_VERIFY=true
             shift
             ;;
+        --lockstep)
+            LOCKSTEP_ARGS=(--lockstep)
+            shift
+            ;;
         --test)
             SINGLE_TEST="$2"
             shift 2
             ;;
         --help|-h)
-            head -26 "$0" | tail -24
+            head -27 "$0" | tail -25
             exit 0
             ;;
         *)
@@ -177,7 +183,11 @@ run_test() {
         
         if [[ -f "$ref_file" ]]; then
             echo -e "${YELLOW}Running headless verification ($frames frames)...${NC}"
-            if "./$exe_name" --headless "$frames" --compare "$ref_file" 2>&1 | grep -q "DISPLAY_MATCH: PASS"; then
+            local verify_output
+            verify_output=$("./$exe_name" --headless "$frames" "${LOCKSTEP_ARGS[@]}" --compare "$ref_file" 2>&1) || true
+            echo "$verify_output" | grep -A20 "LOCKSTEP DIVERGENCE" || true
+            if echo "$verify_output" | grep -q "DISPLAY_MATCH: PASS" &&
+               ! echo "$verify_output" | grep -q "LOCKSTEP DIVERGENCE"; then
                 echo -e "${GREEN}✓ Display verification passed${NC}"
                 ((PASSED++))
             else